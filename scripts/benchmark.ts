@@ -0,0 +1,216 @@
+import { createHash } from "node:crypto";
+import { readFile, writeFile } from "node:fs/promises";
+import { resolve } from "node:path";
+import { parseArgs } from "node:util";
+import { glob } from "tinyglobby";
+import { version } from "../package.json";
+
+/**
+ * Reads the blackbox corpus with the fast / slow / pure option sets and the rotations of
+ * `tests/testEntries.ts`, and reports throughput, latency percentiles per barcode format, the bytes
+ * copied into the WASM heap and the peak heap size as JSON, so runs can be diffed between releases.
+ *
+ * ```sh
+ * pnpm -s bench:corpus --output baseline.json
+ * pnpm -s bench:corpus --wasm scanx_reader_mt_simd.wasm --filter qrcode
+ * ```
+ */
+
+const { values: args } = parseArgs({
+  options: {
+    // The reader entry loads the multithreaded build in Node.js
+    wasm: { type: "string", default: "scanx_reader_mt.wasm" },
+    iterations: { type: "string", default: "1" },
+    filter: { type: "string" },
+    output: { type: "string" },
+  },
+});
+
+// Substituted at build time by vite (see vite.config.ts), but these sources are run through tsx.
+Object.assign(globalThis, {
+  NPM_PACKAGE_VERSION: version,
+  READER_HASH: "",
+  READER_SIMD_HASH: "",
+  READER_MT_HASH: "",
+  READER_MT_SIMD_HASH: "",
+  READER_QR_HASH: "",
+  READER_QR_SIMD_HASH: "",
+  READER_LINEAR_HASH: "",
+  READER_LINEAR_SIMD_HASH: "",
+  READER_MATRIX_HASH: "",
+  READER_MATRIX_SIMD_HASH: "",
+  WRITER_HASH: "",
+  WRITER_SIMD_HASH: "",
+  FULL_HASH: "",
+  FULL_SIMD_HASH: "",
+  SUBMODULE_COMMIT: "",
+});
+
+const { prepareScanXModule, readBarcodes } = await import(
+  "../src/reader/index.js"
+);
+const { testEntries } = await import("../tests/testEntries.js");
+const {
+  DEFAULT_READER_OPTIONS_FOR_TESTS,
+  getRotatedImage,
+  isLinearBarcodeFormat,
+  warmUpCache,
+} = await import("../tests/utils.js");
+
+type Type = "fast" | "slow" | "pure";
+
+interface Percentiles {
+  p50: number;
+  p95: number;
+  p99: number;
+}
+
+interface TypeReport {
+  reads: number;
+  detected: number;
+  seconds: number;
+  imagesPerSecond: number;
+  bytesCopied: number;
+  /**
+   * Latency in milliseconds per barcode format of the corpus directory.
+   */
+  formats: Record<string, Percentiles & { reads: number }>;
+}
+
+const SAMPLES_PATH_PREFIX = "zxing-cpp/test/samples";
+
+const wasmBinary = await readFile(
+  resolve(import.meta.dirname, "../src/reader", args.wasm),
+);
+const ScanXModule = await prepareScanXModule({
+  overrides: { wasmBinary: wasmBinary.buffer as ArrayBuffer },
+  fireImmediately: true,
+});
+
+// Every input is copied into the heap through one `_malloc` of its exact size.
+let bytesCopied = 0;
+const malloc = ScanXModule._malloc;
+ScanXModule._malloc = (size: number) => {
+  bytesCopied += size;
+  return malloc(size);
+};
+
+function percentiles(latencies: number[]): Percentiles {
+  const sorted = [...latencies].sort((a, b) => a - b);
+  const rank = (p: number) =>
+    sorted[Math.min(sorted.length - 1, Math.ceil(p * sorted.length) - 1)];
+  const round = (ms: number) => Math.round(ms * 1000) / 1000;
+  return {
+    p50: round(rank(0.5)),
+    p95: round(rank(0.95)),
+    p99: round(rank(0.99)),
+  };
+}
+
+const iterations = Math.max(1, Number(args.iterations));
+const latencies: Record<Type, Record<string, number[]>> = {
+  fast: {},
+  slow: {},
+  pure: {},
+};
+const reports: Record<string, TypeReport> = {};
+
+for (const type of ["fast", "slow", "pure"] as const) {
+  let reads = 0;
+  let detected = 0;
+  let seconds = 0;
+  const bytesCopiedBefore = bytesCopied;
+
+  for (const {
+    directory,
+    barcodeFormat,
+    testFast = true,
+    testSlow = true,
+    testPure = false,
+    rotations = isLinearBarcodeFormat(barcodeFormat)
+      ? [0, 180]
+      : [0, 90, 180, 270],
+    readerOptions = DEFAULT_READER_OPTIONS_FOR_TESTS,
+  } of testEntries) {
+    if (args.filter && !directory.includes(args.filter)) continue;
+    if (!{ fast: testFast, slow: testSlow, pure: testPure }[type]) continue;
+
+    const appliedReaderOptions = {
+      ...readerOptions,
+      tryHarder: type === "slow",
+      tryRotate: type === "slow",
+      tryInvert: type === "slow",
+      isPure: type === "pure",
+      binarizer: type === "pure" ? "FixedThreshold" : "LocalAverage",
+    } as const;
+    const imagePaths = await glob([
+      `${SAMPLES_PATH_PREFIX}/${directory}/*.(png|jpg|pgm|gif)`,
+    ]);
+    if (imagePaths.length === 0) continue;
+    const formatLatencies = (latencies[type][barcodeFormat] ??= []);
+
+    for (const imagePath of imagePaths) {
+      const imageRotations = type === "pure" ? [0] : rotations;
+      await warmUpCache(imagePath, imageRotations);
+      for (const rotation of imageRotations) {
+        const image = await getRotatedImage(imagePath, rotation);
+        for (let i = 0; i < iterations; ++i) {
+          const start = performance.now();
+          const [barcode] = await readBarcodes(image, appliedReaderOptions);
+          const latency = performance.now() - start;
+          formatLatencies.push(latency);
+          seconds += latency / 1000;
+          reads += 1;
+          if (barcode?.isValid) detected += 1;
+        }
+      }
+    }
+  }
+
+  if (reads === 0) continue;
+  reports[type] = {
+    reads,
+    detected,
+    seconds: Math.round(seconds * 1000) / 1000,
+    imagesPerSecond: Math.round((reads / seconds) * 100) / 100,
+    bytesCopied: bytesCopied - bytesCopiedBefore,
+    formats: Object.fromEntries(
+      Object.entries(latencies[type]).map(([format, formatLatencies]) => [
+        format,
+        { reads: formatLatencies.length, ...percentiles(formatLatencies) },
+      ]),
+    ),
+  };
+}
+
+const report = {
+  version,
+  wasm: args.wasm,
+  wasmSha256: createHash("sha256").update(wasmBinary).digest("hex"),
+  node: process.version,
+  platform: `${process.platform}-${process.arch}`,
+  iterations,
+  bytesCopied,
+  // WASM memory only ever grows, so its final size is the peak.
+  peakHeapBytes: ScanXModule.HEAPU8.buffer.byteLength,
+  types: reports,
+};
+
+// A human readable summary goes to stderr, so stdout only carries the JSON report.
+for (const [type, { reads, imagesPerSecond, formats }] of Object.entries(
+  reports,
+)) {
+  console.error(`${type}: ${reads} reads, ${imagesPerSecond} images/s`);
+  for (const [format, { p50, p95, p99 }] of Object.entries(formats)) {
+    console.error(
+      `  ${format.padEnd(16)} p50 ${p50} ms, p95 ${p95} ms, p99 ${p99} ms`,
+    );
+  }
+}
+
+const json = `${JSON.stringify(report, null, 2)}\n`;
+if (args.output) {
+  await writeFile(args.output, json);
+} else {
+  process.stdout.write(json);
+}
@@ -5,8 +5,10 @@ import viteConfig from "../vite.config.js";
 async function buildIife() {
   await rimraf("dist/iife");
   await Promise.all(
-    Object.entries((viteConfig.build?.lib as LibraryOptions).entry).map(
-      ([entryAlias, entryPath]) => {
+    Object.entries((viteConfig.build?.lib as LibraryOptions).entry)
+      // The worker pool runs on Node.js only
+      .filter(([entryAlias]) => !entryAlias.startsWith("pool/"))
+      .map(([entryAlias, entryPath]) => {
         return build({
           ...viteConfig,
           build: {
@@ -25,8 +27,7 @@ async function buildIife() {
           },
           configFile: false,
         });
-      },
-    ),
+      }),
   );
 }
 
@@ -0,0 +1,56 @@
+import { readFile } from "node:fs/promises";
+import { glob } from "tinyglobby";
+
+/**
+ * Fails when a SIMD `.wasm` imports or exports anything its scalar build does
+ * not, or the other way round. The loader runs both binaries with the JS glue
+ * of the scalar build (see `resolveWasmVariant`), which only works as long as
+ * the two agree on these lists. Runs after `build:wasm:simd`, so the scalar
+ * builds have to be there.
+ *
+ * ```sh
+ * pnpm -s check:simd
+ * ```
+ */
+
+type Entry = { module?: string; name: string; kind: string };
+
+function describe(entries: Entry[]) {
+  return entries
+    .map(
+      ({ module, name, kind }) =>
+        `${module ? `${module}.` : ""}${name} (${kind})`,
+    )
+    .sort();
+}
+
+async function signatureOf(path: string) {
+  const module = await WebAssembly.compile(await readFile(path));
+  return {
+    imports: describe(WebAssembly.Module.imports(module)),
+    exports: describe(WebAssembly.Module.exports(module)),
+  };
+}
+
+const simdPaths = await glob("src/{reader,writer,full}/*_simd.wasm");
+let mismatches = 0;
+
+for (const simdPath of simdPaths.sort()) {
+  const scalarPath = simdPath.replace(/_simd\.wasm$/, ".wasm");
+  const [scalar, simd] = await Promise.all([
+    signatureOf(scalarPath),
+    signatureOf(simdPath),
+  ]);
+  for (const list of ["imports", "exports"] as const) {
+    const missing = scalar[list].filter((entry) => !simd[list].includes(entry));
+    const extra = simd[list].filter((entry) => !scalar[list].includes(entry));
+    if (missing.length === 0 && extra.length === 0) continue;
+    ++mismatches;
+    console.error(`${simdPath} ${list} differ from ${scalarPath}:`);
+    for (const entry of missing) console.error(`  - ${entry}`);
+    for (const entry of extra) console.error(`  + ${entry}`);
+  }
+}
+
+if (mismatches > 0) process.exit(1);
+console.log(`${simdPaths.length} SIMD variants match their scalar builds`);
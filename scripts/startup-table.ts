@@ -0,0 +1,115 @@
+import { readFile, writeFile } from "node:fs/promises";
+import { resolve } from "node:path";
+import { parseArgs } from "node:util";
+import { gzipSync } from "node:zlib";
+import { version } from "../package.json";
+
+/**
+ * Measures the size, the gzipped size and the median compile and instantiate
+ * time of every reader build and its SIMD variant, and prints them as the
+ * markdown table of the README. With `--write`, the table between the
+ * `startup-table` markers of the README is replaced instead.
+ *
+ * ```sh
+ * pnpm -s build:wasm
+ * pnpm -s docs:startup --iterations 20 --write
+ * ```
+ */
+
+const { values: args } = parseArgs({
+  options: {
+    iterations: { type: "string", default: "10" },
+    write: { type: "boolean", default: false },
+  },
+});
+
+// Substituted at build time by vite (see vite.config.ts), but these sources are run through tsx.
+Object.assign(globalThis, {
+  NPM_PACKAGE_VERSION: version,
+  READER_HASH: "",
+  READER_SIMD_HASH: "",
+  READER_MT_HASH: "",
+  READER_MT_SIMD_HASH: "",
+  READER_QR_HASH: "",
+  READER_QR_SIMD_HASH: "",
+  READER_LINEAR_HASH: "",
+  READER_LINEAR_SIMD_HASH: "",
+  READER_MATRIX_HASH: "",
+  READER_MATRIX_SIMD_HASH: "",
+  WRITER_HASH: "",
+  WRITER_SIMD_HASH: "",
+  FULL_HASH: "",
+  FULL_SIMD_HASH: "",
+  SUBMODULE_COMMIT: "",
+});
+
+const reader = await import("../src/reader/index.js");
+const readerQR = await import("../src/reader-qr/index.js");
+const readerLinear = await import("../src/reader-linear/index.js");
+const readerMatrix = await import("../src/reader-matrix/index.js");
+const { READER_WASM } = await import("../tests/utils.js");
+
+const README_PATH = resolve(import.meta.dirname, "../README.md");
+const START_MARKER = "<!-- startup-table:start -->";
+const END_MARKER = "<!-- startup-table:end -->";
+
+const kB = (bytes: number) => Math.round(bytes / 1024);
+const iterations = Math.max(1, Number(args.iterations));
+
+const rows = [
+  "| `.wasm` file | Size | Gzipped | Compile and instantiate (median) |",
+  "| ------------ | ---: | ------: | -------------------------------: |",
+];
+
+for (const [entry, scalarFile] of [
+  [reader, READER_WASM],
+  [readerQR, "scanx_reader_qr.wasm"],
+  [readerLinear, "scanx_reader_linear.wasm"],
+  [readerMatrix, "scanx_reader_matrix.wasm"],
+] as const) {
+  for (const wasmFile of [
+    scalarFile,
+    scalarFile.replace(/\.wasm$/, "_simd.wasm"),
+  ]) {
+    const wasmBinary = await readFile(
+      resolve(import.meta.dirname, "../src/reader", wasmFile),
+    );
+    const startupMs: number[] = [];
+    for (let i = 0; i < iterations; ++i) {
+      entry.purgeScanXModule();
+      const start = performance.now();
+      await entry.prepareScanXModule({
+        overrides: { wasmBinary: wasmBinary.buffer as ArrayBuffer },
+        fireImmediately: true,
+      });
+      startupMs.push(performance.now() - start);
+    }
+    startupMs.sort((a, b) => a - b);
+    const cells = [
+      `\`${wasmFile}\``,
+      `${kB(wasmBinary.byteLength)} kB`,
+      `${kB(gzipSync(wasmBinary).byteLength)} kB`,
+      `${startupMs[Math.floor(startupMs.length / 2)].toFixed(1)} ms`,
+    ];
+    rows.push(`| ${cells.join(" | ")} |`);
+  }
+}
+
+const machine = `Node.js ${process.version} on ${process.platform}/${process.arch}`;
+const table = [
+  ...rows,
+  "",
+  `Measured with ${machine}, ${iterations} runs each (\`pnpm -s docs:startup\`).`,
+].join("\n");
+
+if (args.write) {
+  const readme = await readFile(README_PATH, "utf8");
+  const start = readme.indexOf(START_MARKER);
+  const end = readme.indexOf(END_MARKER);
+  if (start < 0 || end < start)
+    throw new Error("README has no startup-table markers");
+  const before = readme.slice(0, start + START_MARKER.length);
+  await writeFile(README_PATH, `${before}\n\n${table}\n\n${readme.slice(end)}`);
+} else {
+  console.log(table);
+}
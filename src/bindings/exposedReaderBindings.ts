@@ -3,6 +3,8 @@ import { type ReaderOptions, defaultReaderOptions as ro } from "./index.js";
 export const defaultReaderOptions: Required<ReaderOptions> = {
   ...ro,
   formats: [...ro.formats],
+  regions: Array.isArray(ro.regions) ? [...ro.regions] : { ...ro.regions },
+  cascade: [...ro.cascade],
 };
 
 export {
@@ -10,6 +12,7 @@ export {
   type Binarizer,
   barcodeFormats,
   binarizers,
+  type CascadeTier,
   type CharacterSet,
   type ContentType,
   characterSets,
@@ -22,12 +25,18 @@ export {
   linearBarcodeFormats,
   type MatrixBarcodeFormat,
   matrixBarcodeFormats,
+  type PackedResultField,
   type Point,
   type Position,
+  type ProfiledReadResults,
+  packedResultFields,
   type ReaderOptions,
+  type ReaderStats,
   type ReadInputBarcodeFormat,
   type ReadOutputBarcodeFormat,
+  type ReadProfile,
   type ReadResult,
+  type Rect,
   type ScanXPoint,
   type ScanXPosition,
   type ScanXReaderOptions,
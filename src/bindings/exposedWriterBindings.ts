@@ -1,6 +1,9 @@
 import { type WriterOptions, defaultWriterOptions as wo } from "./index.js";
 
-export const defaultWriterOptions: Required<WriterOptions> = { ...wo };
+export const defaultWriterOptions: Required<WriterOptions> = {
+  ...wo,
+  outputs: [...wo.outputs],
+};
 
 export {
   type BarcodeFormat,
@@ -13,9 +16,15 @@ export {
   linearBarcodeFormats,
   type MatrixBarcodeFormat,
   matrixBarcodeFormats,
+  type Pixmap,
+  type PixmapFormat,
+  pixmapFormats,
   type ScanXWriteResult,
   type ScanXWriterOptions,
+  type WriteCacheStats,
   type WriteInputBarcodeFormat,
+  type WriteOutput,
   type WriteResult,
   type WriterOptions,
+  writeOutputs,
 } from "./index.js";
@@ -4,10 +4,16 @@ export * from "./characterSet.js";
 export * from "./contentType.js";
 export * from "./eanAddOnSymbol.js";
 export * from "./ecLevel.js";
+export * from "./packedReadResult.js";
+export * from "./packedWriteResult.js";
 export * from "./position.js";
 export * from "./readerOptions.js";
+export * from "./readProfile.js";
 export * from "./readResult.js";
+export * from "./rect.js";
 export * from "./textMode.js";
 export * from "./vector.js";
+export * from "./writeCache.js";
+export * from "./writeOutput.js";
 export * from "./writeResult.js";
 export * from "./writerOptions.js";
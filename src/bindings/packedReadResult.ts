@@ -0,0 +1,302 @@
+import { decodeFormat, type ReadOutputBarcodeFormat } from "./barcodeFormat.js";
+import type { BarcodeSymbol } from "./barcodeSymbol.js";
+import { type ContentType, decodeContentType } from "./contentType.js";
+import type { EcLevel } from "./ecLevel.js";
+import type { Position } from "./position.js";
+import type { ProfiledReadResults } from "./readProfile.js";
+import type { ReadResult } from "./readResult.js";
+import { decodeUtf8 } from "./utf8.js";
+
+/**
+ * Optional fields of a packed read result, in the order of their bits in the packed field mask.
+ */
+export const packedResultFields = [
+  "bytes",
+  "bytesECI",
+  "symbol",
+  "extra",
+] as const;
+
+/**
+ * A {@link ReadResult | `ReadResult`} field that can be left out of packed read results.
+ *
+ * Omitted fields read as empty values: an empty `Uint8Array` for `"bytes"` and `"bytesECI"`,
+ * an empty string for `"extra"` and a `0 x 0` symbol for `"symbol"`.
+ */
+export type PackedResultField = (typeof packedResultFields)[number];
+
+/**
+ * Encodes the fields to omit into the mask of fields to pack.
+ *
+ * @param omitFields - Fields to leave out of the packed results
+ * @returns A number with one bit set for every field to pack
+ */
+export function encodePackedResultFields(
+  omitFields: PackedResultField[],
+): number {
+  return packedResultFields.reduce(
+    (fields, field, index) =>
+      omitFields.includes(field) ? fields : fields | (1 << index),
+    0,
+  );
+}
+
+/**
+ * Int32 word indices of the fields of a packed record, mirroring `PackedRecord` in `ScanXCore.h`.
+ * Variable length fields are stored as an (offset, length) pair into the data section.
+ */
+const Word = {
+  Status: 0,
+  Format: 1,
+  ContentType: 2,
+  Flags: 3,
+  Orientation: 4,
+  SequenceSize: 5,
+  SequenceIndex: 6,
+  LineCount: 7,
+  Position: 8,
+  Text: 16,
+  Error: 18,
+  EcLevel: 20,
+  SymbologyIdentifier: 22,
+  SequenceId: 24,
+  Version: 26,
+  Extra: 28,
+  Message: 30,
+  Bytes: 32,
+  BytesECI: 34,
+  Symbol: 36,
+  SymbolWidth: 38,
+  SymbolHeight: 39,
+} as const;
+
+const Flag = {
+  IsValid: 1 << 0,
+  HasECI: 1 << 1,
+  IsMirrored: 1 << 2,
+  IsInverted: 1 << 3,
+  ReaderInit: 1 << 4,
+} as const;
+
+const HEADER_SIZE = 8;
+
+/**
+ * A read result backed by a packed buffer. Fields are decoded on access, nothing is converted
+ * for fields that are never read.
+ */
+class PackedReadResult implements ReadResult {
+  #buffer: Uint8Array;
+  #view: DataView;
+  #record: number;
+  #data: number;
+
+  constructor(
+    buffer: Uint8Array,
+    view: DataView,
+    record: number,
+    data: number,
+  ) {
+    this.#buffer = buffer;
+    this.#view = view;
+    this.#record = record;
+    this.#data = data;
+  }
+
+  #int(word: number) {
+    return this.#view.getInt32(this.#record + word * 4, true);
+  }
+
+  #span(word: number) {
+    const offset = this.#data + this.#int(word);
+    return this.#buffer.subarray(offset, offset + this.#int(word + 1));
+  }
+
+  #string(word: number) {
+    return decodeUtf8(this.#span(word));
+  }
+
+  #point(index: number) {
+    return {
+      x: this.#int(Word.Position + 2 * index),
+      y: this.#int(Word.Position + 2 * index + 1),
+    };
+  }
+
+  get isValid() {
+    return (this.#int(Word.Flags) & Flag.IsValid) !== 0;
+  }
+
+  get error() {
+    return this.#string(Word.Error);
+  }
+
+  get format(): ReadOutputBarcodeFormat {
+    return decodeFormat(this.#int(Word.Format));
+  }
+
+  get bytes() {
+    return this.#span(Word.Bytes);
+  }
+
+  get bytesECI() {
+    return this.#span(Word.BytesECI);
+  }
+
+  get text() {
+    return this.#string(Word.Text);
+  }
+
+  get ecLevel() {
+    return this.#string(Word.EcLevel) as EcLevel;
+  }
+
+  get eccLevel() {
+    return this.ecLevel;
+  }
+
+  get contentType(): ContentType {
+    return decodeContentType(this.#int(Word.ContentType));
+  }
+
+  get hasECI() {
+    return (this.#int(Word.Flags) & Flag.HasECI) !== 0;
+  }
+
+  get position(): Position {
+    return {
+      topLeft: this.#point(0),
+      topRight: this.#point(1),
+      bottomRight: this.#point(2),
+      bottomLeft: this.#point(3),
+    };
+  }
+
+  get orientation() {
+    return this.#int(Word.Orientation);
+  }
+
+  get isMirrored() {
+    return (this.#int(Word.Flags) & Flag.IsMirrored) !== 0;
+  }
+
+  get isInverted() {
+    return (this.#int(Word.Flags) & Flag.IsInverted) !== 0;
+  }
+
+  get symbologyIdentifier() {
+    return this.#string(Word.SymbologyIdentifier);
+  }
+
+  get sequenceSize() {
+    return this.#int(Word.SequenceSize);
+  }
+
+  get sequenceIndex() {
+    return this.#int(Word.SequenceIndex);
+  }
+
+  get sequenceId() {
+    return this.#string(Word.SequenceId);
+  }
+
+  get readerInit() {
+    return (this.#int(Word.Flags) & Flag.ReaderInit) !== 0;
+  }
+
+  get lineCount() {
+    return this.#int(Word.LineCount);
+  }
+
+  get version() {
+    return this.#string(Word.Version);
+  }
+
+  get symbol(): BarcodeSymbol {
+    const data = this.#span(Word.Symbol);
+    return {
+      data: new Uint8ClampedArray(
+        data.buffer,
+        data.byteOffset,
+        data.byteLength,
+      ),
+      width: this.#int(Word.SymbolWidth),
+      height: this.#int(Word.SymbolHeight),
+    };
+  }
+
+  get extra() {
+    return this.#string(Word.Extra);
+  }
+
+  get message() {
+    return this.#string(Word.Message);
+  }
+
+  get status() {
+    return this.#int(Word.Status);
+  }
+}
+
+/**
+ * Wraps a packed result buffer into read results with lazy accessors.
+ *
+ * @param buffer - A packed result buffer owned by JS, i.e. already copied out of the module heap
+ * @returns An array of read results sharing `buffer`
+ */
+export function unpackReadResults(buffer: Uint8Array): ReadResult[] {
+  const view = new DataView(
+    buffer.buffer,
+    buffer.byteOffset,
+    buffer.byteLength,
+  );
+  const count = view.getInt32(0, true);
+  const recordSize = view.getInt32(4, true);
+  const data = HEADER_SIZE + count * recordSize;
+  const readResults: ReadResult[] = [];
+  for (let i = 0; i < count; ++i) {
+    readResults.push(
+      new PackedReadResult(buffer, view, HEADER_SIZE + i * recordSize, data),
+    );
+  }
+  return readResults;
+}
+
+/**
+ * Splits a packed batch buffer into the read results of every image.
+ * The packed results are prefixed with the number of images, then for every image the number
+ * of records up to and including it, then for every image the cascade tier that read it, then
+ * for every image its flags (bit 0: the time budget was exceeded).
+ *
+ * @param buffer - A packed batch buffer owned by JS, i.e. already copied out of the module heap
+ * @param cascade - Whether a cascade was configured, i.e. whether to attach the cascade tiers
+ * @param timeBudget - Whether a time budget was configured, i.e. whether to attach `budgetExceeded`
+ * @returns One array of read results per image, in the order of the images
+ */
+export function unpackBatchReadResults(
+  buffer: Uint8Array,
+  cascade = false,
+  timeBudget = false,
+): ProfiledReadResults[] {
+  const view = new DataView(
+    buffer.buffer,
+    buffer.byteOffset,
+    buffer.byteLength,
+  );
+  const count = view.getInt32(0, true);
+  const readResults = unpackReadResults(buffer.subarray((3 * count + 1) * 4));
+  const batchReadResults: ProfiledReadResults[] = [];
+  for (let i = 0, start = 0; i < count; ++i) {
+    const end = view.getInt32((i + 1) * 4, true);
+    const imageReadResults: ProfiledReadResults = readResults.slice(start, end);
+    if (cascade) {
+      imageReadResults.cascadeTier = view.getInt32((count + i + 1) * 4, true);
+    }
+    if (timeBudget) {
+      const flags = view.getInt32((2 * count + i + 1) * 4, true);
+      imageReadResults.budgetExceeded = (flags & 1) !== 0;
+    }
+    batchReadResults.push(imageReadResults);
+    start = end;
+  }
+  return batchReadResults;
+}
@@ -0,0 +1,117 @@
+import type { BarcodeSymbol } from "./barcodeSymbol.js";
+import { decodeUtf8 } from "./utf8.js";
+import type { Pixmap, WriteResult } from "./writeResult.js";
+
+/**
+ * Int32 word indices of the fields of a packed batch entry, mirroring `PackedWriteEntry` in `ScanXCore.h`.
+ * Variable length fields are stored as an (offset, length) pair into the data section.
+ */
+const Word = {
+  Error: 0,
+  Png: 2,
+  Svg: 4,
+  Utf8: 6,
+  Symbol: 8,
+  SymbolWidth: 10,
+  SymbolHeight: 11,
+  Pixmap: 12,
+  PixmapWidth: 14,
+  PixmapHeight: 15,
+} as const;
+
+const HEADER_SIZE = 8;
+
+/**
+ * A write result backed by a packed batch buffer. Outputs are only converted when accessed.
+ */
+class PackedWriteResult implements WriteResult {
+  #buffer: Uint8Array;
+  #view: DataView;
+  #entry: number;
+  #data: number;
+
+  constructor(
+    buffer: Uint8Array,
+    view: DataView,
+    entry: number,
+    data: number,
+  ) {
+    this.#buffer = buffer;
+    this.#view = view;
+    this.#entry = entry;
+    this.#data = data;
+  }
+
+  #int(word: number) {
+    return this.#view.getInt32(this.#entry + word * 4, true);
+  }
+
+  #span(word: number) {
+    const offset = this.#data + this.#int(word);
+    return this.#buffer.subarray(offset, offset + this.#int(word + 1));
+  }
+
+  #clamped(word: number) {
+    const span = this.#span(word);
+    return new Uint8ClampedArray(span.buffer, span.byteOffset, span.byteLength);
+  }
+
+  get error() {
+    return decodeUtf8(this.#span(Word.Error));
+  }
+
+  get svg() {
+    return decodeUtf8(this.#span(Word.Svg));
+  }
+
+  get utf8() {
+    return decodeUtf8(this.#span(Word.Utf8));
+  }
+
+  get image() {
+    const png = this.#span(Word.Png);
+    return png.byteLength
+      ? new Blob([new Uint8Array(png)], { type: "image/png" })
+      : null;
+  }
+
+  get symbol(): BarcodeSymbol {
+    return {
+      data: this.#clamped(Word.Symbol),
+      width: this.#int(Word.SymbolWidth),
+      height: this.#int(Word.SymbolHeight),
+    };
+  }
+
+  get pixmap(): Pixmap | null {
+    const width = this.#int(Word.PixmapWidth);
+    const height = this.#int(Word.PixmapHeight);
+    return width && height
+      ? { data: this.#clamped(Word.Pixmap), width, height }
+      : null;
+  }
+}
+
+/**
+ * Wraps a packed batch buffer into write results with lazy accessors.
+ *
+ * @param buffer - A packed batch buffer owned by JS, i.e. already copied out of the module heap
+ * @returns An array of write results sharing `buffer`, in the order of the inputs
+ */
+export function unpackWriteResults(buffer: Uint8Array): WriteResult[] {
+  const view = new DataView(
+    buffer.buffer,
+    buffer.byteOffset,
+    buffer.byteLength,
+  );
+  const count = view.getInt32(0, true);
+  const entrySize = view.getInt32(4, true);
+  const data = HEADER_SIZE + count * entrySize;
+  const writeResults: WriteResult[] = [];
+  for (let i = 0; i < count; ++i) {
+    writeResults.push(
+      new PackedWriteResult(buffer, view, HEADER_SIZE + i * entrySize, data),
+    );
+  }
+  return writeResults;
+}
@@ -0,0 +1,114 @@
+import { decodeFormat, type ReadOutputBarcodeFormat } from "./barcodeFormat.js";
+import type { ReadResult } from "./readResult.js";
+
+/**
+ * @internal
+ */
+export interface ScanXReadProfile {
+  /**
+   * Decoding an encoded image (PNG, JPEG, ...) to luma, or converting an RGBA pixmap to luma.
+   */
+  decodeMs: number;
+  /**
+   * Checking the access token.
+   */
+  authMs: number;
+  /**
+   * Detecting and decoding the barcodes.
+   */
+  readMs: number;
+  /**
+   * Converting the barcodes to results, inside the module and in JS.
+   */
+  marshalMs: number;
+}
+
+/**
+ * Time spent in every stage of a read, in milliseconds.
+ * Returned with the results of a read when {@link ReaderOptions.profile | `profile`} is enabled.
+ */
+export interface ReadProfile extends ScanXReadProfile {
+  /**
+   * The whole call, including copying the input into the WASM heap.
+   */
+  totalMs: number;
+}
+
+/**
+ * Read results, with the {@link ReadProfile | `ReadProfile`} of the read attached when
+ * {@link ReaderOptions.profile | `profile`} is enabled.
+ */
+export type ProfiledReadResults<R extends ReadResult = ReadResult> = R[] & {
+  profile?: ReadProfile;
+  /**
+   * Index of the {@link ReaderOptions.cascade | `cascade`} tier that found a valid barcode, or `-1`
+   * if none did. Only set when a cascade is configured.
+   */
+  cascadeTier?: number;
+  /**
+   * Whether passes of the read were skipped because its
+   * {@link ReaderOptions.timeBudgetMs | `timeBudgetMs`} ran out. Only set when a budget is configured.
+   */
+  budgetExceeded?: boolean;
+  /**
+   * Whether the frame was close enough to the last scanned one that its results were reused
+   * without reading it. Only set by a `ScannerSession` with change detection enabled.
+   */
+  unchanged?: boolean;
+};
+
+/**
+ * @internal
+ */
+export interface ScanXReaderStats {
+  calls: number;
+  formats: { format: number; count: number; readMs: number }[];
+  heapHighWater: number;
+  allocations: number;
+}
+
+/**
+ * Cumulative counters over every read of a module instance since it was created or the stats
+ * were last reset.
+ */
+export interface ReaderStats {
+  /**
+   * Number of images read.
+   */
+  calls: number;
+  /**
+   * For every barcode format read so far, the number of barcodes and the time spent in the reads
+   * that found them. A read that found several formats counts towards each of them.
+   */
+  formats: Partial<
+    Record<ReadOutputBarcodeFormat, { count: number; readMs: number }>
+  >;
+  /**
+   * The largest size of the WASM heap seen after a read, in bytes.
+   */
+  heapHighWater: number;
+  /**
+   * Number of heap allocations made by the module.
+   */
+  allocations: number;
+}
+
+/**
+ * Converts the reader stats of the module, keyed by format name.
+ *
+ * @param ScanXReaderStats - The raw stats of the module
+ * @returns The stats with decoded barcode formats
+ */
+export function ScanXReaderStatsToReaderStats(
+  ScanXReaderStats: ScanXReaderStats,
+): ReaderStats {
+  return {
+    ...ScanXReaderStats,
+    formats: Object.fromEntries(
+      ScanXReaderStats.formats.map(({ format, count, readMs }) => [
+        decodeFormat(format),
+        { count, readMs },
+      ]),
+    ),
+  };
+}
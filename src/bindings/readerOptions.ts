@@ -2,6 +2,7 @@ import { encodeFormats, type ReadInputBarcodeFormat } from "./barcodeFormat.js";
 import { type Binarizer, encodeBinarizer } from "./binarizer.js";
 import { type CharacterSet, encodeCharacterSet } from "./characterSet.js";
 import { type EanAddOnSymbol, encodeEanAddOnSymbol } from "./eanAddOnSymbol.js";
+import type { Rect } from "./rect.js";
 import { encodeTextMode, type TextMode } from "./textMode.js";
 
 /**
@@ -74,6 +75,70 @@ export interface ScanXReaderOptions {
    * @see {@link tryDownscale | `tryDownscale`} {@link downscaleThreshold | `downscaleThreshold`}
    */
   downscaleFactor: number;
+  /**
+   * Downscale encoded images (PNG, JPEG, ...) after decoding them, before reading.
+   *
+   * This is a post-decode downscale: the image is still decoded at its full resolution, so the
+   * decode takes as long and peaks at as much memory as without this option (for an animated GIF,
+   * all of its frames at full size). The decoded image is then box-filtered down by the largest
+   * whole factor that keeps `min(width, height)` at or above `downscaleThreshold * downscaleFactor`,
+   * and the memory it no longer needs is freed. ZXing builds its downscaled layers from the reduced
+   * image, so only the read itself works on far fewer pixels. Small symbols that only resolve at
+   * the full resolution may be missed. The {@link ReadResult.position | `ReadResult.position`}
+   * and `regions` stay in the coordinates of the full image.
+   *
+   * Only takes effect when {@link tryDownscale | `tryDownscale`} is enabled. Pixel inputs (`ImageData`,
+   * luma and YUV planes) are never reduced.
+   *
+   * @experimental
+   * @defaultValue `false`
+   * @see {@link tryDownscale | `tryDownscale`} {@link downscaleThreshold | `downscaleThreshold`} {@link downscaleFactor | `downscaleFactor`}
+   */
+  downscaleOnDecode: boolean;
+  /**
+   * Read images whose reader working memory would exceed this many bytes in overlapping tiles.
+   *
+   * ZXing needs a few bytes per pixel on top of the image to read it (the binarized image and the
+   * inverted, denoised and downscaled copies), which adds up on 100+ megapixel scans. With a limit,
+   * such images are split into a grid of tiles sized so that all tiles read at the same time stay
+   * within it. The multithreaded reader reads the tiles in parallel, the other builds one by one.
+   * A symbol found in several overlapping tiles is only reported once, and the
+   * {@link ReadResult.position | `ReadResult.position`} of every result is given in the coordinates
+   * of the full image.
+   *
+   * The limit covers the reading only: the decoded image itself still takes one byte per pixel.
+   * Has no effect on reads with `regions`. `0` reads every image in one piece.
+   *
+   * @experimental
+   * @defaultValue `0`
+   * @see {@link tileOverlap | `tileOverlap`}
+   */
+  tileMemoryLimit: number;
+  /**
+   * Number of pixels neighbouring tiles share, see {@link tileMemoryLimit | `tileMemoryLimit`}.
+   * Symbols smaller than the overlap are always read whole by at least one tile.
+   * The tiles never exceed `tileMemoryLimit`: when it only allows tiles of less than twice the
+   * overlap, the overlap is reduced to fit, and larger symbols may be cut by every tile.
+   *
+   * @experimental
+   * @defaultValue `256`
+   */
+  tileOverlap: number;
+  /**
+   * Time budget of reading one image, in milliseconds, for predictable tail latency.
+   *
+   * A read runs as a series of passes: the tiers of a {@link cascade | `cascade`}, the `regions`,
+   * the tiles of {@link tileMemoryLimit | `tileMemoryLimit`} and the full scans of a tracking
+   * session. Once the budget is used up, the remaining passes are skipped and the barcodes found so
+   * far are returned, with {@link ProfiledReadResults.budgetExceeded | `budgetExceeded`} set.
+   * A single pass cannot be interrupted, so the first pass always runs and a read can exceed the
+   * budget by the length of the pass that was running. Images of a batch and frames of an animated
+   * GIF each get their own budget.
+   *
+   * @experimental
+   * @defaultValue `0` (no budget)
+   */
+  timeBudgetMs: number;
   /**
    * The number of scan lines in a linear barcode that have to be equal to accept the result.
    *
@@ -100,6 +165,16 @@ export interface ScanXReaderOptions {
    * @see {@link ReadResult.error | `ReadResult.error`}
    */
   returnErrors: boolean;
+  /**
+   * If `true`, measure the time spent in every stage of the read and attach it to the returned
+   * results as {@link ProfiledReadResults.profile | `profile`}. Profiling is off by default, so
+   * reads that do not ask for it return no `profile`. They still query the clock a few times, to
+   * time the read for the counters of `getReaderStats` and to check the access token.
+   *
+   * @defaultValue `false`
+   * @see {@link ReadProfile | `ReadProfile`}
+   */
+  profile: boolean;
   /**
    * @internal
    */
@@ -112,8 +187,36 @@ export interface ScanXReaderOptions {
    * @internal
    */
   characterSet: number;
+  /**
+   * @internal
+   */
+  regions: Rect[];
+  /**
+   * @internal
+   */
+  cascade: ScanXCascadeTier[];
 }
 
+/**
+ * The reader options a {@link CascadeTier | `CascadeTier`} can change.
+ */
+type CascadeTierOption =
+  | "tryHarder"
+  | "tryRotate"
+  | "tryInvert"
+  | "tryDownscale"
+  | "tryDenoise"
+  | "binarizer"
+  | "isPure"
+  | "downscaleThreshold"
+  | "downscaleFactor"
+  | "minLineCount";
+
+/**
+ * @internal
+ */
+export type ScanXCascadeTier = Pick<ScanXReaderOptions, CascadeTierOption>;
+
 /**
  * Reader options for reading barcodes.
  */
@@ -121,7 +224,13 @@ export interface ReaderOptions
   extends Partial<
     Omit<
       ScanXReaderOptions,
-      "formats" | "binarizer" | "eanAddOnSymbol" | "textMode" | "characterSet"
+      | "formats"
+      | "binarizer"
+      | "eanAddOnSymbol"
+      | "textMode"
+      | "characterSet"
+      | "regions"
+      | "cascade"
     >
   > {
   accessToken: string;
@@ -214,8 +323,52 @@ export interface ReaderOptions
    * @defaultValue `"Unknown"`
    */
   characterSet?: CharacterSet;
+  /**
+   * One or more regions of interest to read instead of the whole image.
+   *
+   * Each region is read through a cropped view over the same pixels, so no image data is copied.
+   * The {@link ReadResult.position | `ReadResult.position`} of every result is still given in the
+   * coordinates of the full image. Regions are clamped to the image bounds, and a symbol found in
+   * several overlapping regions is only reported once.
+   * An empty list `[]` reads the whole image.
+   *
+   * @defaultValue `[]`
+   */
+  regions?: Rect | Rect[];
+  /**
+   * Option tiers to read with in turn, usually from cheap to thorough.
+   *
+   * Every tier reads the same image inside one call, so the image is copied into the WASM heap,
+   * decoded and the access token is checked only once. The first tier that finds a valid barcode ends
+   * the read, and its index is attached to the returned results as
+   * {@link ProfiledReadResults.cascadeTier | `cascadeTier`}. If no tier finds one, the results of the
+   * last tier are returned and `cascadeTier` is `-1`.
+   *
+   * Options left out of a tier keep the value of these reader options. The options of these reader
+   * options themselves are only used by the tiers, not read with on their own.
+   * An empty list `[]` reads once with these reader options.
+   *
+   * @example
+   * ```ts
+   * const readResults = await readBarcodes(imageFile, {
+   *   cascade: [
+   *     { tryHarder: false, tryRotate: false, tryInvert: false },
+   *     { tryHarder: true, tryRotate: true, tryInvert: true, tryDenoise: true },
+   *   ],
+   * });
+   * readResults.cascadeTier; // 0 if the fast tier was enough
+   * ```
+   *
+   * @defaultValue `[]`
+   */
+  cascade?: CascadeTier[];
 }
 
+/**
+ * One tier of a {@link ReaderOptions.cascade | `cascade`}: the reader options to change for this tier.
+ */
+export type CascadeTier = Partial<Pick<ReaderOptions, CascadeTierOption>>;
+
 export const defaultReaderOptions: Required<ReaderOptions> = {
   formats: [],
   tryHarder: true,
@@ -227,14 +380,21 @@ export const defaultReaderOptions: Required<ReaderOptions> = {
   isPure: false,
   downscaleFactor: 3,
   downscaleThreshold: 500,
+  downscaleOnDecode: false,
+  tileMemoryLimit: 0,
+  tileOverlap: 256,
+  timeBudgetMs: 0,
   minLineCount: 2,
   maxNumberOfSymbols: 255,
   tryCode39ExtendedMode: true,
   returnErrors: false,
+  profile: false,
   eanAddOnSymbol: "Ignore",
   textMode: "HRI",
   characterSet: "Unknown",
   accessToken: "",
+  regions: [],
+  cascade: [],
 };
 
 /**
@@ -247,6 +407,21 @@ export const defaultReaderOptions: Required<ReaderOptions> = {
 export function readerOptionsToScanXReaderOptions(
   readerOptions: Required<ReaderOptions>,
 ): ScanXReaderOptions {
+  const cascade = readerOptions.cascade.map((tier): ScanXCascadeTier => {
+    const options = { ...readerOptions, ...tier };
+    return {
+      tryHarder: options.tryHarder,
+      tryRotate: options.tryRotate,
+      tryInvert: options.tryInvert,
+      tryDownscale: options.tryDownscale,
+      tryDenoise: options.tryDenoise,
+      binarizer: encodeBinarizer(options.binarizer),
+      isPure: options.isPure,
+      downscaleThreshold: options.downscaleThreshold,
+      downscaleFactor: options.downscaleFactor,
+      minLineCount: options.minLineCount,
+    };
+  });
   return {
     ...readerOptions,
     formats: encodeFormats(readerOptions.formats),
@@ -254,5 +429,9 @@ export function readerOptionsToScanXReaderOptions(
     eanAddOnSymbol: encodeEanAddOnSymbol(readerOptions.eanAddOnSymbol),
     textMode: encodeTextMode(readerOptions.textMode),
     characterSet: encodeCharacterSet(readerOptions.characterSet),
+    regions: Array.isArray(readerOptions.regions)
+      ? readerOptions.regions
+      : [readerOptions.regions],
+    cascade,
   };
 }
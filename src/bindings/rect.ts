@@ -0,0 +1,21 @@
+/**
+ * An axis-aligned rectangle in image pixel coordinates.
+ */
+export interface Rect {
+  /**
+   * X coordinate of the left edge.
+   */
+  x: number;
+  /**
+   * Y coordinate of the top edge.
+   */
+  y: number;
+  /**
+   * Width of the rectangle.
+   */
+  width: number;
+  /**
+   * Height of the rectangle.
+   */
+  height: number;
+}
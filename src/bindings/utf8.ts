@@ -0,0 +1,12 @@
+let textDecoder: TextDecoder | undefined;
+
+/**
+ * Decodes utf8 bytes into a string, creating the shared decoder on first use.
+ *
+ * @param bytes - The utf8 encoded bytes
+ * @returns The decoded string
+ */
+export function decodeUtf8(bytes: Uint8Array): string {
+  textDecoder ??= new TextDecoder();
+  return textDecoder.decode(bytes);
+}
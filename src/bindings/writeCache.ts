@@ -0,0 +1,26 @@
+/**
+ * Counters of the cache of generated barcodes of a module instance, see
+ * {@link setWriteCacheCapacity | `setWriteCacheCapacity`}.
+ */
+export interface WriteCacheStats {
+  /**
+   * Number of writes served from the cache since it was created or last purged.
+   */
+  hits: number;
+  /**
+   * Number of writes that had to create the barcode, since it was created or last purged.
+   */
+  misses: number;
+  /**
+   * Number of cached barcodes.
+   */
+  entries: number;
+  /**
+   * Bytes taken by the cached outputs and their keys.
+   */
+  bytes: number;
+  /**
+   * Upper bound of `bytes`, `0` if the cache is off.
+   */
+  capacity: number;
+}
@@ -0,0 +1,55 @@
+export const writeOutputs = ["png", "svg", "utf8", "symbol", "pixmap"] as const;
+
+/**
+ * An output that {@link writeBarcode | `writeBarcode`} can produce.
+ *
+ * - `"png"`: {@link WriteResult.image | `WriteResult.image`}, a PNG encoded image blob
+ * - `"svg"`: {@link WriteResult.svg | `WriteResult.svg`}
+ * - `"utf8"`: {@link WriteResult.utf8 | `WriteResult.utf8`}
+ * - `"symbol"`: {@link WriteResult.symbol | `WriteResult.symbol`}
+ * - `"pixmap"`: {@link WriteResult.pixmap | `WriteResult.pixmap`}, the raw rendered pixels
+ */
+export type WriteOutput = (typeof writeOutputs)[number];
+
+/**
+ * Encodes a list of write outputs into a bit mask.
+ *
+ * @param outputs - The outputs to encode
+ * @returns A number with one bit set for every output
+ */
+export function encodeWriteOutputs(outputs: WriteOutput[]): number {
+  return outputs.reduce(
+    (mask, output) => mask | (1 << writeOutputs.indexOf(output)),
+    0,
+  );
+}
+
+export const pixmapFormats = ["Lum", "RGBA"] as const;
+
+/**
+ * Pixel layout of {@link WriteResult.pixmap | `WriteResult.pixmap`}.
+ *
+ * - `"Lum"`: one gray byte per pixel
+ * - `"RGBA"`: four bytes per pixel, ready to be wrapped into an `ImageData`
+ */
+export type PixmapFormat = (typeof pixmapFormats)[number];
+
+/**
+ * Encodes a pixmap format to its numeric representation.
+ *
+ * @param pixmapFormat - The pixmap format to encode
+ * @returns A number representing the encoded pixmap format
+ */
+export function encodePixmapFormat(pixmapFormat: PixmapFormat): number {
+  return pixmapFormats.indexOf(pixmapFormat);
+}
+
+/**
+ * Decodes a pixmap format from its numeric representation.
+ *
+ * @param number - The numeric identifier of the pixmap format
+ * @returns The decoded pixmap format
+ */
+export function decodePixmapFormat(number: number): PixmapFormat {
+  return pixmapFormats[number];
+}
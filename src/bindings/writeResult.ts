@@ -1,5 +1,35 @@
 import type { BarcodeSymbol } from "./barcodeSymbol.js";
 
+/**
+ * @internal
+ */
+export interface ScanXPixmap {
+  /**
+   * A view into the module heap, only valid until the next write.
+   */
+  data?: Uint8Array;
+  width: number;
+  height: number;
+}
+
+/**
+ * The rendered barcode as raw pixels, see {@link WriterOptions.pixmapFormat | `WriterOptions.pixmapFormat`}.
+ */
+export interface Pixmap {
+  /**
+   * Pixel data, row by row without padding.
+   */
+  data: Uint8ClampedArray;
+  /**
+   * Width of the pixmap.
+   */
+  width: number;
+  /**
+   * Height of the pixmap.
+   */
+  height: number;
+}
+
 /**
  * @internal
  */
@@ -27,6 +57,10 @@ export interface ScanXWriteResult {
    * Barcode symbol in the shape of a one-channel image.
    */
   symbol: BarcodeSymbol;
+  /**
+   * @internal
+   */
+  pixmap: ScanXPixmap;
 }
 
 /**
@@ -34,7 +68,8 @@ export interface ScanXWriteResult {
  *
  * @experimental The final form of this API is not yet settled and may change.
  */
-export interface WriteResult extends Omit<ScanXWriteResult, "image"> {
+export interface WriteResult
+  extends Omit<ScanXWriteResult, "image" | "pixmap"> {
   /**
    * The encoded barcode as an image blob.
    * If some error happens, this will be `null`.
@@ -42,6 +77,11 @@ export interface WriteResult extends Omit<ScanXWriteResult, "image"> {
    * @see {@link WriteResult.error | `WriteResult.error`}
    */
   image: Blob | null;
+  /**
+   * The rendered barcode as raw pixels, if `"pixmap"` is one of the
+   * {@link WriterOptions.outputs | `WriterOptions.outputs`}. Otherwise this will be `null`.
+   */
+  pixmap: Pixmap | null;
 }
 
 /**
@@ -54,10 +94,12 @@ export interface WriteResult extends Omit<ScanXWriteResult, "image"> {
  * The function creates a new object that spreads all properties from the input result,
  * but converts the image data from a Uint8Array to a PNG Blob when present.
  * If no image data exists, the image property will be null.
+ * The pixmap is copied out of the module heap, as the heap view is reused by the next write.
  */
 export function ScanXWriteResultToWriteResult(
   ScanXWriteResult: ScanXWriteResult,
-) {
+): WriteResult {
+  const { data, width, height } = ScanXWriteResult.pixmap;
   return {
     ...ScanXWriteResult,
     image:
@@ -66,5 +108,6 @@ export function ScanXWriteResultToWriteResult(
           type: "image/png",
         })) ??
       null,
+    pixmap: data ? { data: new Uint8ClampedArray(data), width, height } : null,
   };
 }
@@ -1,5 +1,11 @@
 import { encodeFormat, type WriteInputBarcodeFormat } from "./barcodeFormat.js";
 import type { EcLevel } from "./ecLevel.js";
+import {
+  encodePixmapFormat,
+  encodeWriteOutputs,
+  type PixmapFormat,
+  type WriteOutput,
+} from "./writeOutput.js";
 
 /**
  * @internal
@@ -84,13 +90,40 @@ export interface ScanXWriterOptions {
    * @defaultValue `""`
    */
   options: string;
+  /**
+   * @internal
+   */
+  outputs: number;
+  /**
+   * The zlib compression level of the PNG image, from `0` (fastest, largest) to `9` (slowest, smallest).
+   *
+   * @defaultValue `8`
+   */
+  pngCompressionLevel: number;
+  /**
+   * @internal
+   */
+  pixmapFormat: number;
+  /**
+   * @internal
+   */
+  pixmapPtr: number;
+  /**
+   * @internal
+   */
+  pixmapCapacity: number;
 }
 
 /**
  * Writer options for writing barcodes.
  */
 export interface WriterOptions
-  extends Partial<Omit<ScanXWriterOptions, "format">> {
+  extends Partial<
+    Omit<
+      ScanXWriterOptions,
+      "format" | "outputs" | "pixmapFormat" | "pixmapPtr" | "pixmapCapacity"
+    >
+  > {
   /**
    * The format of the barcode to write.
    *
@@ -103,6 +136,22 @@ export interface WriterOptions
    * @defaultValue `"QRCode"`
    */
   format?: WriteInputBarcodeFormat;
+  /**
+   * The outputs to produce. Outputs that are not listed are not generated at all and are empty
+   * in the {@link WriteResult | `WriteResult`}: `image` and `pixmap` are `null`, `svg` and `utf8`
+   * are `""` and `symbol` has a size of `0 x 0`.
+   *
+   * The barcode is only rendered to a bitmap if `"png"` or `"pixmap"` is requested.
+   *
+   * @defaultValue `["png", "svg", "utf8", "symbol"]`
+   */
+  outputs?: WriteOutput[];
+  /**
+   * Pixel layout of {@link WriteResult.pixmap | `WriteResult.pixmap`}.
+   *
+   * @defaultValue `"RGBA"`
+   */
+  pixmapFormat?: PixmapFormat;
 }
 
 export const defaultWriterOptions: Required<WriterOptions> = {
@@ -116,6 +165,9 @@ export const defaultWriterOptions: Required<WriterOptions> = {
   withHRT: false,
   withQuietZones: true,
   options: "",
+  outputs: ["png", "svg", "utf8", "symbol"],
+  pngCompressionLevel: 8,
+  pixmapFormat: "RGBA",
 };
 
 /**
@@ -130,5 +182,9 @@ export function writerOptionsToScanXWriterOptions(
   return {
     ...writerOptions,
     format: encodeFormat(writerOptions.format),
+    outputs: encodeWriteOutputs(writerOptions.outputs),
+    pixmapFormat: encodePixmapFormat(writerOptions.pixmapFormat),
+    pixmapPtr: 0,
+    pixmapCapacity: 0,
   };
 }
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2016 Nu-book Inc.
+ * Copyright 2023 Axel Waggershauser
+ * Copyright 2023 Ze-Zheng Wu
+ */
+// SPDX-License-Identifier: Apache-2.0
+
+// Native command line reader: reads every image of a directory on a thread pool and prints the results as JSON.
+// Every image goes through BatchReader::readImage, the same decode and read path as readBarcodesFromImages
+// of the WASM modules, so the timings and profiles taken here carry over to the browser builds.
+#include "ScanXCore.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+  // Images are read and printed this many at a time, so memory stays flat on large directories
+  constexpr int kChunkSize = 256;
+
+  constexpr const char *kUsage = R"(Usage: scanx_cli [options] <directory>
+
+Reads the barcodes of every image in <directory> and prints them as JSON.
+
+Options:
+  --threads <n>            worker threads, defaults to the number of cores
+  --formats <list>         barcode formats to read, e.g. QRCode,EAN-13, defaults to all
+  --max-symbols <n>        stop after <n> barcodes per image, defaults to 255
+  --fast                   turn off tryHarder, tryRotate and tryInvert
+  --cascade                read with --fast first and only retry a miss with all options, see ReaderOptions.cascade
+  --downscale-on-decode    downscale large images after decoding, see ReaderOptions.downscaleOnDecode
+  --tile-memory-limit <mb> read images that need more memory in overlapping tiles, see ReaderOptions.tileMemoryLimit
+  --time-budget <ms>       stop reading an image at the next pass after <ms>, see ReaderOptions.timeBudgetMs
+  --return-errors          also return barcodes that failed to decode
+  --access-token <token>   defaults to the SCANX_ACCESS_TOKEN environment variable
+)";
+
+  struct CliOptions {
+    std::filesystem::path directory;
+    unsigned threads = 0;
+    bool cascade = false;
+    ReaderConfig config;
+  };
+
+  // Returns false with a message on stderr if the arguments are not usable.
+  bool parseArguments(int argc, char **argv, CliOptions &options) {
+    options.config.readerOptions.setMaxNumberOfSymbols(255);
+    if (const char *accessToken = std::getenv("SCANX_ACCESS_TOKEN")) options.config.accessToken = accessToken;
+
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      try {
+        if (arg == "--threads" && hasValue) {
+          options.threads = std::stoul(argv[++i]);
+        } else if (arg == "--formats" && hasValue) {
+          options.config.readerOptions.setFormats(ZXing::BarcodeFormatsFromString(argv[++i]));
+        } else if (arg == "--max-symbols" && hasValue) {
+          options.config.readerOptions.setMaxNumberOfSymbols(std::clamp(std::stoi(argv[++i]), 0, 255));
+        } else if (arg == "--fast") {
+          options.config.readerOptions.setTryHarder(false).setTryRotate(false).setTryInvert(false);
+        } else if (arg == "--cascade") {
+          options.cascade = true;
+        } else if (arg == "--downscale-on-decode") {
+          options.config.downscaleOnDecode = true;
+        } else if (arg == "--tile-memory-limit" && hasValue) {
+          options.config.tileMemoryLimit = std::stoul(argv[++i]) << 20;
+        } else if (arg == "--time-budget" && hasValue) {
+          options.config.timeBudgetMs = std::stod(argv[++i]);
+        } else if (arg == "--return-errors") {
+          options.config.readerOptions.setReturnErrors(true);
+        } else if (arg == "--access-token" && hasValue) {
+          options.config.accessToken = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+          return false;
+        } else if (!arg.empty() && arg[0] != '-' && options.directory.empty()) {
+          options.directory = arg;
+        } else {
+          std::cerr << "Unknown or incomplete option: " << arg << '\n';
+          return false;
+        }
+      } catch (const std::exception &e) {
+        std::cerr << "Invalid value for " << arg << ": " << e.what() << '\n';
+        return false;
+      }
+    }
+
+    if (options.directory.empty()) {
+      std::cerr << "Missing <directory>\n";
+      return false;
+    }
+    if (options.cascade) {
+      const auto &readerOptions = options.config.readerOptions;
+      options.config.cascade = {ZXing::ReaderOptions(readerOptions).setTryHarder(false).setTryRotate(false).setTryInvert(false), readerOptions};
+    }
+    return true;
+  }
+
+  std::string jsonString(std::string_view value) {
+    std::string json = "\"";
+    json.reserve(value.size() + 2);
+    for (char c : value) {
+      switch (c) {
+        case '"':
+          json += "\\\"";
+          break;
+        case '\\':
+          json += "\\\\";
+          break;
+        case '\n':
+          json += "\\n";
+          break;
+        case '\r':
+          json += "\\r";
+          break;
+        case '\t':
+          json += "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[7];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            json += escaped;
+          } else {
+            json += c;
+          }
+      }
+    }
+    return json + '"';
+  }
+
+  std::string barcodeJson(const ZXing::Barcode &barcode) {
+    std::string json = "{\"format\":" + jsonString(ZXing::ToString(barcode.format()));
+    json += ",\"text\":" + jsonString(barcode.text());
+    json += ",\"isValid\":" + std::string(barcode.isValid() ? "true" : "false");
+    json += ",\"error\":" + jsonString(ZXing::ToString(barcode.error()));
+    json += ",\"symbologyIdentifier\":" + jsonString(barcode.symbologyIdentifier());
+    json += ",\"orientation\":" + std::to_string(barcode.orientation());
+    json += ",\"position\":[";
+    for (int i = 0; i < 4; ++i) {
+      if (i) json += ',';
+      json += '[' + std::to_string(barcode.position()[i].x) + ',' + std::to_string(barcode.position()[i].y) + ']';
+    }
+    return json + "]}";
+  }
+
+  std::string imageJson(const std::filesystem::path &path, const BatchReader::ImageResult &image) {
+    std::string json = "{\"path\":" + jsonString(path.string());
+    json += ",\"status\":" + std::to_string(image.status);
+    if (image.status != 200) {
+      json += ",\"error\":" + jsonString(image.error);
+      json += ",\"message\":" + jsonString(image.message);
+    }
+    json += ",\"readMs\":" + std::to_string(image.readMs);
+    json += ",\"cascadeTier\":" + std::to_string(image.cascadeTier);
+    json += ",\"budgetExceeded\":" + std::string(image.budgetExceeded ? "true" : "false");
+    json += ",\"barcodes\":[";
+    for (std::size_t i = 0; i < image.barcodes.size(); ++i) {
+      if (i) json += ',';
+      json += barcodeJson(image.barcodes[i]);
+    }
+    return json + "]}";
+  }
+
+  std::string statsJson(double elapsedMs) {
+    std::string json = "{\"calls\":" + std::to_string(static_cast<uint64_t>(readerStats.calls));
+    json += ",\"elapsedMs\":" + std::to_string(elapsedMs);
+    json += ",\"allocations\":" + std::to_string(allocationCount.load());
+    json += ",\"formats\":{";
+    bool first = true;
+    for (const auto &[format, stats] : readerStats.formats) {
+      if (!first) json += ',';
+      first = false;
+      json += jsonString(ZXing::ToString(static_cast<ZXing::BarcodeFormat>(format)));
+      json += ":{\"count\":" + std::to_string(static_cast<uint64_t>(stats.count)) + ",\"readMs\":" + std::to_string(stats.readMs) + '}';
+    }
+    return json + "}}";
+  }
+
+  std::vector<uint8_t> readFile(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  }
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+  CliOptions options;
+  if (!parseArguments(argc, argv, options)) {
+    std::cerr << kUsage;
+    return 2;
+  }
+
+  // Checked once for the whole run, like a batch of the WASM module
+  AuthResponse auth = isAccessTokenIsValidToday(options.config.accessToken);
+  if (auth.status != 200) {
+    std::cerr << "Access token rejected: " << statusToMessage(auth.status) << '\n';
+    return 1;
+  }
+
+  std::vector<std::filesystem::path> paths;
+  std::error_code error;
+  for (const auto &entry : std::filesystem::directory_iterator(options.directory, error))
+    if (entry.is_regular_file()) paths.push_back(entry.path());
+  if (error) {
+    std::cerr << "Cannot list " << options.directory << ": " << error.message() << '\n';
+    return 2;
+  }
+  std::sort(paths.begin(), paths.end());
+
+  ThreadPool::instance(options.threads ? options.threads : ThreadPool::defaultSize());
+  auto start = Clock::now();
+
+  std::cout << "{\"images\":[";
+  for (std::size_t first = 0; first < paths.size(); first += kChunkSize) {
+    const int count = static_cast<int>(std::min<std::size_t>(kChunkSize, paths.size() - first));
+    auto images = parallelMap(count, [&](int i) {
+      auto bytes = readFile(paths[first + i]);
+      return BatchReader::readImage(bytes.data(), static_cast<int>(bytes.size()), options.config);
+    });
+    for (int i = 0; i < count; ++i) {
+      if (images[i].status == 200) readerStats.add(images[i].barcodes, images[i].readMs);
+      std::cout << (first + i ? ",\n" : "\n") << imageJson(paths[first + i], images[i]);
+    }
+  }
+  std::cout << "\n],\"stats\":" << statsJson(elapsedMs(start)) << "}\n";
+  return 0;
+}
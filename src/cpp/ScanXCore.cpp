@@ -0,0 +1,1320 @@
+/*
+ * Copyright 2016 Nu-book Inc.
+ * Copyright 2023 Axel Waggershauser
+ * Copyright 2023 Ze-Zheng Wu
+ */
+// SPDX-License-Identifier: Apache-2.0
+#include "ScanXCore.h"
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+// ------------------------------start my include import-------------------------------
+// this for isDateValid
+#include <ctime>
+//------------------------------- env my include or import---------------------------------
+
+#if defined(__wasm_simd128__)
+  #include <wasm_simd128.h>
+#endif
+
+#if defined(READER)
+  #define STBI_MALLOC(size) decodeMalloc(size)
+  #define STBI_REALLOC_SIZED(ptr, oldSize, newSize) decodeRealloc(ptr, oldSize, newSize)
+  #define STBI_FREE(ptr) decodeFree(ptr)
+  #define STB_IMAGE_IMPLEMENTATION
+  #include <stb_image.h>
+#endif
+
+#if defined(READER) && defined(SCANX_THREADS)
+  #include "BitMatrix.h"
+  #include "HybridBinarizer.h"
+#endif
+
+#if defined(WRITER)
+  #define STB_IMAGE_WRITE_IMPLEMENTATION
+  #include <stb_image_write.h>
+#endif
+
+#if defined(READER)
+
+// ------------------------------------------start my types------------------
+// Define the struct to hold the response
+struct DecryptedResponse {
+  int status; // Status code
+  std::string decrypted;
+};
+
+// ------------------------------------------end my types------------------
+// ------------------------------------------------start my custom functions----------------------------------------------------------------
+// Status Codes for isValidDateFormat
+// Code	Description
+// 103	Date format is not supported.
+// Status Codes for isDateValidToday
+// Code	Description
+// 200	Date matches today's date.
+// Status Code for Timeout
+// Code	Description
+// 408	Request or operation timed out.
+// 400	Invalid key provided.
+
+std::string statusToMessage(const int &status) {
+  switch (status) {
+    case 103:
+      return "Date format is not supported.";
+    case 200:
+      return "Date matches today's date.";
+    case 408:
+      return "Request or operation timed out.";
+    case 400:
+      return "Invalid key provided.";
+    case 403:
+      return "Forbidden.";
+    default:
+      return "Unknown Error.";
+  }
+}
+
+namespace {
+
+  // Decoded access token layout: ":__DD-MM-YYYY__:"
+  constexpr std::size_t kDateLength = 16;
+  // Every encrypted character is "XXKKSSSS": xor byte, key byte and the 4 digit key checksum
+  constexpr std::size_t kSegmentLength = 8;
+  constexpr std::size_t kKeyLength = 36;
+
+  int hexDigit(char c) {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  }
+
+  int decimalDigits(const char *p, int count) {
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+      if (p[i] < '0' || p[i] > '9')
+        return -1;
+      value = value * 10 + (p[i] - '0');
+    }
+    return value;
+  }
+
+  // Today's local date and the time range it covers, so the verdict can be reused until midnight.
+  struct LocalDay {
+    int day;
+    int month;
+    int year;
+    time_t begin;
+    time_t end;
+  };
+
+  LocalDay localDayOf(time_t t) {
+    tm date = *localtime(&t);
+    LocalDay localDay{.day = date.tm_mday, .month = date.tm_mon + 1, .year = date.tm_year + 1900};
+    date.tm_hour = date.tm_min = date.tm_sec = 0;
+    date.tm_isdst = -1;
+    localDay.begin = mktime(&date);
+    date.tm_mday += 1;
+    date.tm_isdst = -1;
+    localDay.end = mktime(&date);
+    return localDay;
+  }
+
+  struct AccessTokenCache {
+    std::string accessToken;
+    AuthResponse response;
+    time_t validFrom = 0;
+    time_t validUntil = 0;
+  };
+
+  AccessTokenCache accessTokenCache;
+
+} // namespace
+
+AuthResponse isDateValidToday(const std::string &inputDate, const LocalDay &today) {
+  int day = decimalDigits(inputDate.data() + 3, 2);
+  int month = decimalDigits(inputDate.data() + 6, 2);
+  int year = decimalDigits(inputDate.data() + 9, 4);
+
+  AuthResponse response;
+  if (day == today.day && month == today.month && year == today.year) {
+    response.status = 200;
+  } else {
+    std::cout << "scanx-core-151" << std::endl;
+    response.status = 408;
+  }
+  return response;
+}
+
+// Checksum of the key as it appears in every encrypted segment: the sum of its characters as 4 lower case hex digits
+int calculateSumOfKey(const std::string &key) {
+  int sum = 0;
+  for (char c : key) {
+    sum += static_cast<int>(c);
+  }
+  return sum;
+}
+
+// Decrypt a message
+// Function to decrypt the input using the correct key
+DecryptedResponse customDecrypt(const std::string &encrypted, const std::string &key) {
+  DecryptedResponse response{.status = 401};
+  if (encrypted.length() % kSegmentLength != 0) {
+    std::cerr << "Encrypted string too short" << '\n';
+    return response;
+  }
+  int sumOfKey = calculateSumOfKey(key);
+  // A checksum outside of 4 hex digits can never match the segment checksum
+  if (sumOfKey < 0 || sumOfKey > 0xffff) {
+    std::cerr << "Invalid key or corrupted data" << '\n';
+    return response;
+  }
+  static constexpr char lowerHex[] = "0123456789abcdef";
+  const char checksum[4] = {
+    lowerHex[(sumOfKey >> 12) & 0xf], lowerHex[(sumOfKey >> 8) & 0xf], lowerHex[(sumOfKey >> 4) & 0xf], lowerHex[sumOfKey & 0xf]
+  };
+
+  response.decrypted.reserve(encrypted.length() / kSegmentLength);
+  for (std::size_t i = 0; i < encrypted.length(); i += kSegmentLength) {
+    const char *segment = encrypted.data() + i;
+    if (!std::equal(checksum, checksum + 4, segment + 4)) {
+      std::cerr << "Invalid key or corrupted data" << '\n';
+      response.decrypted.clear();
+      return response;
+    }
+    int xorHigh = hexDigit(segment[0]), xorLow = hexDigit(segment[1]);
+    int keyHigh = hexDigit(segment[2]), keyLow = hexDigit(segment[3]);
+    if ((xorHigh | xorLow | keyHigh | keyLow) < 0) {
+      std::cerr << "Invalid hex in encrypted string" << '\n';
+      response.decrypted.clear();
+      return response;
+    }
+    response.decrypted += static_cast<char>(((xorHigh << 4) | xorLow) ^ ((keyHigh << 4) | keyLow));
+  }
+  response.status = 200;
+  return response;
+}
+
+// Matches ":__DD-MM-YYYY__:" with DD in 00-31 and MM in 01-12
+bool isValidDateFormat(const std::string &date) {
+  if (date.length() != kDateLength || date.compare(0, 3, ":__") != 0 || date[5] != '-' || date[8] != '-' || date.compare(13, 3, "__:") != 0) {
+    return false;
+  }
+  int day = decimalDigits(date.data() + 3, 2);
+  int month = decimalDigits(date.data() + 6, 2);
+  int year = decimalDigits(date.data() + 9, 4);
+  return day >= 0 && day <= 31 && month >= 1 && month <= 12 && year >= 0;
+}
+
+AuthResponse validateAccessToken(const std::string &accessToken, const LocalDay &today) {
+  AuthResponse response{.status = 400};
+  if (accessToken.empty()) {
+    std::cout << "Logic Error: Access token -> is empty" << std::endl;
+    return response;
+  }
+  if (accessToken.length() < kKeyLength) {
+    std::cout << "Logic Error: Access token -> key is too short" << std::endl;
+    return response;
+  }
+  std::string key = accessToken.substr(0, kKeyLength);
+  std::string encrypted = accessToken.substr(kKeyLength);
+  if (encrypted.empty()) {
+    std::cout << "Logic Error: Access token -> encrypted is empty" << std::endl;
+    return response;
+  }
+  if (encrypted.length() < kSegmentLength) {
+    std::cout << "Runtime Error: Encrypted string too short" << std::endl;
+    return response;
+  }
+  DecryptedResponse decryptedRes = customDecrypt(encrypted, key);
+  if (decryptedRes.status != 200) {
+    response.status = decryptedRes.status;
+    return response;
+  }
+  if (!isValidDateFormat(decryptedRes.decrypted)) {
+    response.status = 103;
+    return response;
+  }
+  return isDateValidToday(decryptedRes.decrypted, today);
+}
+
+AuthResponse isAccessTokenIsValidToday(const std::string &accessToken) {
+  time_t now = time(0);
+  if (now >= accessTokenCache.validFrom && now < accessTokenCache.validUntil && accessToken == accessTokenCache.accessToken) {
+    return accessTokenCache.response;
+  }
+  LocalDay today = localDayOf(now);
+  accessTokenCache = {
+    .accessToken = accessToken, .response = validateAccessToken(accessToken, today), .validFrom = today.begin, .validUntil = today.end
+  };
+  return accessTokenCache.response;
+}
+//---------------------------------------------------------- env my custom functions-----------------------------------------------
+
+// ------------------ Packed results ------------------
+void PackedReadResults::add(const ZXing::Barcode &barcode) {
+  PackedRecord record{
+    .status = 200,
+    .format = static_cast<int32_t>(barcode.format()),
+    .contentType = static_cast<int32_t>(barcode.contentType()),
+    .flags = barcode.isValid() | barcode.hasECI() << 1 | barcode.isMirrored() << 2 | barcode.isInverted() << 3 | barcode.readerInit() << 4,
+    .orientation = barcode.orientation(),
+    .sequenceSize = barcode.sequenceSize(),
+    .sequenceIndex = barcode.sequenceIndex(),
+    .lineCount = barcode.lineCount(),
+    .text = append(barcode.text()),
+    .error = append(ZXing::ToString(barcode.error())),
+    .ecLevel = append(barcode.ecLevel()),
+    .symbologyIdentifier = append(barcode.symbologyIdentifier()),
+    .sequenceId = append(barcode.sequenceId()),
+    .version = append(barcode.version()),
+    .message = append("success"),
+  };
+  for (int i = 0; i < 4; ++i) {
+    record.position[2 * i] = barcode.position()[i].x;
+    record.position[2 * i + 1] = barcode.position()[i].y;
+  }
+  if (fields & PackedExtra) record.extra = append(barcode.extra());
+  if (fields & PackedBytes) record.bytes = append(barcode.bytes().data(), barcode.bytes().size());
+  if (fields & PackedBytesECI) {
+    auto bytesECI = barcode.bytesECI();
+    record.bytesECI = append(bytesECI.data(), bytesECI.size());
+  }
+  if (fields & PackedSymbol) {
+    auto symbol = barcode.symbol();
+    record.symbol = {static_cast<int32_t>(data.size()), symbol.width() * symbol.height()};
+    for (int y = 0; y < symbol.height(); ++y)
+      append(symbol.data(0, y), symbol.width());
+    record.symbolWidth = symbol.width();
+    record.symbolHeight = symbol.height();
+  }
+  records.push_back(record);
+}
+
+void PackedReadResults::addError(const std::string &error, const std::string &message, int status) {
+  records.push_back({.status = status, .error = append(error), .message = append(message)});
+}
+
+const std::vector<uint8_t> &PackedReadResults::pack(const std::vector<int32_t> &prefix) {
+  const std::size_t prefixSize = prefix.size() * sizeof(int32_t);
+  const std::size_t recordsSize = records.size() * sizeof(PackedRecord);
+  buffer.resize(prefixSize + kHeaderSize + recordsSize + data.size());
+  uint8_t *out = buffer.data();
+  int32_t header[2] = {static_cast<int32_t>(records.size()), sizeof(PackedRecord)};
+  if (prefixSize) std::memcpy(out, prefix.data(), prefixSize);
+  std::memcpy(out + prefixSize, header, kHeaderSize);
+  std::memcpy(out + prefixSize + kHeaderSize, records.data(), recordsSize);
+  std::memcpy(out + prefixSize + kHeaderSize + recordsSize, data.data(), data.size());
+  return buffer;
+}
+
+PackedSpan PackedReadResults::append(const void *bytes, std::size_t length) {
+  PackedSpan span{static_cast<int32_t>(data.size()), static_cast<int32_t>(length)};
+  data.insert(data.end(), static_cast<const uint8_t *>(bytes), static_cast<const uint8_t *>(bytes) + length);
+  return span;
+}
+
+void appendResults(PackedReadResults &packedReadResults, const ZXing::Barcodes &barcodes) {
+  for (const auto &barcode : barcodes)
+    packedReadResults.add(barcode);
+}
+
+void appendError(PackedReadResults &packedReadResults, const std::string &error, const std::string &message, int status) {
+  packedReadResults.addError(error, message, status);
+}
+
+// ------------------ Profiling ------------------
+double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::atomic<uint64_t> allocationCount{0};
+
+// Replaces the global allocator of the whole program, so only the builds that own it opt in
+#if defined(SCANX_COUNT_ALLOCATIONS)
+void *operator new(std::size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+#endif
+
+thread_local ReadProfiler readProfiler;
+
+void ReaderStats::add(const ZXing::Barcodes &barcodes, double readMs) {
+  ++calls;
+#if defined(__wasm__)
+  heapHighWater = std::max(heapHighWater, static_cast<double>(__builtin_wasm_memory_size(0)) * 65536);
+#endif
+  std::map<int, int> found;
+  for (const auto &barcode : barcodes)
+    ++found[static_cast<int>(barcode.format())];
+  // A read that found several formats counts towards the time of each of them
+  for (const auto &[format, count] : found) {
+    formats[format].count += count;
+    formats[format].readMs += readMs;
+  }
+}
+
+void ReaderStats::reset() {
+  calls = 0;
+  heapHighWater = 0;
+  formats.clear();
+  allocationCount = 0;
+}
+
+ReaderStats readerStats;
+
+// ------------------ Reading ------------------
+namespace {
+
+  ZXing::PointI center(const ZXing::Position &position) {
+    ZXing::PointI sum;
+    for (const auto &point : position) {
+      sum.x += point.x;
+      sum.y += point.y;
+    }
+    return {sum.x / 4, sum.y / 4};
+  }
+
+} // anonymous namespace
+
+bool isSameSymbol(const ZXing::Barcode &a, const ZXing::Barcode &b) {
+  if (a.format() != b.format() || a.bytes() != b.bytes()) return false;
+  auto ca = center(a.position()), cb = center(b.position());
+  int extent = std::max(std::abs(a.position()[2].x - a.position()[0].x), std::abs(a.position()[2].y - a.position()[0].y));
+  return std::abs(ca.x - cb.x) <= extent / 2 + 1 && std::abs(ca.y - cb.y) <= extent / 2 + 1;
+}
+
+bool splitFormatFamilies = true;
+
+#if defined(SCANX_THREADS)
+namespace {
+
+  // Binarizes a luma image once with the configured binarizer into black (0) and white (255) pixels, which the
+  // readers of both format families then only have to threshold. Nothing for the threshold binarizers, they are
+  // as cheap as reading the copy.
+  std::optional<ZXing::Matrix<uint8_t>> binarize(const ZXing::ImageView &imageView, ZXing::Binarizer binarizer) {
+    std::unique_ptr<ZXing::BinaryBitmap> bitmap;
+    if (binarizer == ZXing::Binarizer::LocalAverage) {
+      bitmap = std::make_unique<ZXing::HybridBinarizer>(imageView);
+    } else if (binarizer == ZXing::Binarizer::GlobalHistogram) {
+      bitmap = std::make_unique<ZXing::GlobalHistogramBinarizer>(imageView);
+    } else {
+      return std::nullopt;
+    }
+    const ZXing::BitMatrix *bits = bitmap->getBitMatrix();
+    if (!bits) return std::nullopt;
+    return ZXing::ToMatrix<uint8_t>(*bits, 0, 255);
+  }
+
+} // anonymous namespace
+#endif
+
+// The tryRotate / tryInvert / tryDownscale variants run inside a single ReadBarcodes pass that stops early
+// once enough symbols are found, so they cannot be split up without changing the results. Splitting by
+// format family instead runs the variant passes of both families side by side. The downscaled passes then
+// average the shared black and white pixels instead of the original luma.
+ZXing::Barcodes readFormatFamilies(const ZXing::ImageView &imageView, const ZXing::ReaderOptions &readerOptions) {
+#if defined(SCANX_THREADS)
+  ZXing::BarcodeFormats formats = readerOptions.formats().empty() ? ZXing::BarcodeFormat::Any : readerOptions.formats();
+  ZXing::BarcodeFormats families[] = {formats & ZXing::BarcodeFormat::LinearCodes, formats & ZXing::BarcodeFormat::MatrixCodes};
+  if (families[0].empty() || families[1].empty() || !splitFormatFamilies || ThreadPool::isWorkerThread())
+    return ZXing::ReadBarcodes(imageView, readerOptions);
+  // ZXing runs its linear readers first, unless tryHarder moves them last
+  if (readerOptions.tryHarder()) std::swap(families[0], families[1]);
+
+  ZXing::ImageView familyImageView = imageView;
+  ZXing::ReaderOptions familyReaderOptions = readerOptions;
+  std::optional<ZXing::Matrix<uint8_t>> binarized;
+  if (imageView.format() == ZXing::ImageFormat::Lum) binarized = binarize(imageView, readerOptions.binarizer());
+  if (binarized) {
+    familyImageView = ZXing::ImageView(binarized->data(), binarized->width(), binarized->height(), ZXing::ImageFormat::Lum);
+    familyReaderOptions.setBinarizer(ZXing::Binarizer::FixedThreshold);
+  }
+
+  auto familyBarcodes = parallelMap(2, [&](int i) {
+    return ZXing::ReadBarcodes(familyImageView, ZXing::ReaderOptions(familyReaderOptions).setFormats(families[i]));
+  });
+  ZXing::Barcodes barcodes = std::move(familyBarcodes[0]);
+  barcodes.insert(barcodes.end(), std::make_move_iterator(familyBarcodes[1].begin()), std::make_move_iterator(familyBarcodes[1].end()));
+  if (readerOptions.maxNumberOfSymbols() && barcodes.size() > readerOptions.maxNumberOfSymbols())
+    barcodes.resize(readerOptions.maxNumberOfSymbols());
+  // Ordered by position like ZXing orders the results of a pass, so they come back as from a single read
+  std::stable_sort(barcodes.begin(), barcodes.end(), [](const ZXing::Barcode &a, const ZXing::Barcode &b) {
+    auto pa = a.position().topLeft(), pb = b.position().topLeft();
+    return pa.y < pb.y || (pa.y == pb.y && pa.x < pb.x);
+  });
+  return barcodes;
+#else
+  return ZXing::ReadBarcodes(imageView, readerOptions);
+#endif
+}
+
+namespace {
+
+  // Reads `region` of `imageView` as a cropped view over the same pixels, so nothing is copied, and maps the
+  // positions of the results back to the coordinates of the full image. Nothing for regions outside of it.
+  ZXing::Barcodes readRegion(const ZXing::ImageView &imageView, const ZXing::ReaderOptions &readerOptions, const Rect &region) {
+    int left = std::clamp(region.x, 0, imageView.width());
+    int top = std::clamp(region.y, 0, imageView.height());
+    int right = std::clamp(region.x + region.width, left, imageView.width());
+    int bottom = std::clamp(region.y + region.height, top, imageView.height());
+    if (right == left || bottom == top) return {};
+
+    auto barcodes = readFormatFamilies(imageView.cropped(left, top, right - left, bottom - top), readerOptions);
+    for (auto &barcode : barcodes) {
+      auto position = barcode.position();
+      for (auto &point : position) {
+        point.x += left;
+        point.y += top;
+      }
+      barcode.setPosition(position);
+    }
+    return barcodes;
+  }
+
+  // Appends the results of one region that were not already read from an earlier one
+  void appendNewSymbols(ZXing::Barcodes &barcodes, ZXing::Barcodes &&regionBarcodes) {
+    const std::size_t first = barcodes.size();
+    for (auto &barcode : regionBarcodes) {
+      bool duplicate = std::any_of(barcodes.begin(), barcodes.begin() + first, [&](const ZXing::Barcode &other) {
+        return isSameSymbol(other, barcode);
+      });
+      if (!duplicate) barcodes.push_back(std::move(barcode));
+    }
+  }
+
+  // Upper bound of the memory ZXing works with per pixel of a read: the binarized bit matrix plus the
+  // inverted, denoised and downscaled copies of tryInvert / tryDenoise / tryDownscale.
+  constexpr std::size_t kTileBytesPerPixel = 4;
+
+} // anonymous namespace
+
+ZXing::Barcodes readBarcodes(const ZXing::ImageView &imageView, const ZXing::ReaderOptions &readerOptions, const Rects &regions) {
+  if (regions.empty()) return readFormatFamilies(imageView, readerOptions);
+
+  const std::size_t maxNumberOfSymbols = readerOptions.maxNumberOfSymbols();
+  ZXing::ReaderOptions regionReaderOptions = readerOptions;
+  ZXing::Barcodes barcodes;
+
+  for (const auto &region : regions) {
+    if (&region != &regions.front() && !readBudget.allowsNextPass()) break;
+    appendNewSymbols(barcodes, readRegion(imageView, regionReaderOptions, region));
+    if (maxNumberOfSymbols && barcodes.size() >= maxNumberOfSymbols) {
+      barcodes.resize(maxNumberOfSymbols);
+      break;
+    }
+    if (maxNumberOfSymbols) regionReaderOptions.setMaxNumberOfSymbols(maxNumberOfSymbols - barcodes.size());
+  }
+  return barcodes;
+}
+
+Rects tileImage(int width, int height, const ReaderConfig &config) {
+  if (!config.tileMemoryLimit || static_cast<std::size_t>(width) * height * kTileBytesPerPixel <= config.tileMemoryLimit) return {};
+
+  // Tiles read side by side share the limit. Workers read their tiles one by one, see parallelMap.
+  std::size_t concurrency = 1;
+#if defined(SCANX_THREADS)
+  if (!ThreadPool::isWorkerThread()) concurrency = ThreadPool::instance().size();
+#endif
+  const double tilePixels = static_cast<double>(config.tileMemoryLimit) / (kTileBytesPerPixel * concurrency);
+  const int side = std::max(static_cast<int>(std::sqrt(tilePixels)), 1);
+  // The limit wins over the overlap: it shrinks until a tile is larger than twice the overlap, so each tile
+  // still covers pixels of its own
+  const int overlap = std::clamp(config.tileOverlap, 0, (side - 1) / 2);
+  const int step = side - overlap;
+
+  // Spreads `length` evenly over as few tiles of at most `side` pixels as possible
+  auto split = [&](int length, int &count, int &size) {
+    count = std::max(1, (length - overlap + step - 1) / step);
+    size = (length + (count - 1) * overlap + count - 1) / count;
+  };
+  int columns, tileWidth, rows, tileHeight;
+  split(width, columns, tileWidth);
+  split(height, rows, tileHeight);
+  if (columns == 1 && rows == 1) return {};
+
+  Rects tiles;
+  tiles.reserve(static_cast<std::size_t>(columns) * rows);
+  for (int row = 0; row < rows; ++row)
+    for (int column = 0; column < columns; ++column)
+      tiles.push_back({column * (tileWidth - overlap), row * (tileHeight - overlap), tileWidth, tileHeight});
+  return tiles;
+}
+
+// Unlike readBarcodes, every tile is read with the full maxNumberOfSymbols budget, as the tiles are read
+// concurrently. The merged results are cut to the budget afterwards.
+ZXing::Barcodes readTiles(const ZXing::ImageView &imageView, const ZXing::ReaderOptions &readerOptions, const Rects &tiles) {
+  // The budget is thread local, the workers only get to see the deadline
+  const auto deadline = readBudget.deadline;
+  auto tileBarcodes = parallelMap(static_cast<int>(tiles.size()), [&](int i) -> std::optional<ZXing::Barcodes> {
+    if (i > 0 && ReadBudget::expired(deadline)) return std::nullopt;
+    return readRegion(imageView, readerOptions, tiles[i]);
+  });
+
+  ZXing::Barcodes barcodes;
+  for (auto &regionBarcodes : tileBarcodes) {
+    if (regionBarcodes) {
+      appendNewSymbols(barcodes, std::move(*regionBarcodes));
+    } else {
+      readBudget.exceeded = true;
+    }
+  }
+  if (readerOptions.maxNumberOfSymbols() && barcodes.size() > readerOptions.maxNumberOfSymbols())
+    barcodes.resize(readerOptions.maxNumberOfSymbols());
+  return barcodes;
+}
+
+thread_local int cascadeTier = -1;
+
+thread_local ReadBudget readBudget;
+
+// Tiers usually go from cheap to thorough, so a miss of a cheap tier is paid for by the reads it spares.
+ZXing::Barcodes readCascade(const ZXing::ImageView &imageView, const ReaderConfig &config, const Rects &regions) {
+  const Rects tiles = regions.empty() ? tileImage(imageView.width(), imageView.height(), config) : Rects();
+  auto read = [&](const ZXing::ReaderOptions &readerOptions) {
+    return tiles.empty() ? readBarcodes(imageView, readerOptions, regions) : readTiles(imageView, readerOptions, tiles);
+  };
+  if (config.cascade.empty()) return read(config.readerOptions);
+
+  ZXing::Barcodes barcodes;
+  for (std::size_t tier = 0; tier < config.cascade.size(); ++tier) {
+    if (tier > 0 && !readBudget.allowsNextPass()) break;
+    barcodes = read(config.cascade[tier]);
+    if (std::any_of(barcodes.begin(), barcodes.end(), [](const ZXing::Barcode &barcode) { return barcode.isValid(); })) {
+      cascadeTier = static_cast<int>(tier);
+      break;
+    }
+  }
+  return barcodes;
+}
+
+// ------------------ Decoding ------------------
+void *DecodeArena::allocate(std::size_t size) {
+  size = align(size);
+  if (used + size <= capacity) {
+    last = used;
+    used += size;
+    return block + last;
+  }
+  void *ptr = std::malloc(size);
+  if (ptr) {
+    overflow.push_back(ptr);
+    overflowSize += size;
+  }
+  return ptr;
+}
+
+void *DecodeArena::reallocate(void *ptr, std::size_t oldSize, std::size_t newSize) {
+  if (!ptr) return allocate(newSize);
+  if (!owns(ptr)) {
+    void *newPtr = std::realloc(ptr, newSize);
+    if (newPtr) {
+      std::replace(overflow.begin(), overflow.end(), ptr, newPtr);
+      overflowSize += newSize > oldSize ? align(newSize - oldSize) : 0;
+    }
+    return newPtr;
+  }
+  // Growing the most recent allocation (e.g. the zlib output buffer) happens in place when there is room
+  const std::size_t offset = static_cast<uint8_t *>(ptr) - block;
+  if (offset == last && offset + align(newSize) <= capacity) {
+    used = offset + align(newSize);
+    return ptr;
+  }
+  void *newPtr = allocate(newSize);
+  if (newPtr) std::memcpy(newPtr, ptr, std::min(oldSize, newSize));
+  return newPtr;
+}
+
+void DecodeArena::release(void *ptr) {
+  if (!ptr || owns(ptr)) return;
+  overflow.erase(std::remove(overflow.begin(), overflow.end(), ptr), overflow.end());
+  std::free(ptr);
+}
+
+void DecodeArena::reset() {
+  for (void *ptr : overflow)
+    std::free(ptr);
+  overflow.clear();
+  const std::size_t grown = std::min(capacity + overflowSize, kMaxCapacity);
+  if (grown > capacity) {
+    std::free(block);
+    block = static_cast<uint8_t *>(std::malloc(grown));
+    capacity = block ? grown : 0;
+  }
+  overflowSize = 0;
+  used = last = 0;
+}
+
+thread_local DecodeArena *decodeArena = nullptr;
+
+void *decodeMalloc(std::size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  return decodeArena ? decodeArena->allocate(size) : std::malloc(size);
+}
+
+void *decodeRealloc(void *ptr, std::size_t oldSize, std::size_t newSize) {
+  return decodeArena ? decodeArena->reallocate(ptr, oldSize, newSize) : std::realloc(ptr, newSize);
+}
+
+void decodeFree(void *ptr) {
+  if (decodeArena) {
+    decodeArena->release(ptr);
+  } else {
+    std::free(ptr);
+  }
+}
+
+ImageBuffer loadImage(const uint8_t *bufferPtr, int bufferLength, int &width, int &height) {
+  int channels;
+  return ImageBuffer(stbi_load_from_memory(bufferPtr, bufferLength, &width, &height, &channels, 1), stbi_image_free);
+}
+
+ImageBuffer loadFrames(const uint8_t *bufferPtr, int bufferLength, int &width, int &height, int &frameCount) {
+  frameCount = 1;
+  if (bufferLength < 6 || std::memcmp(bufferPtr, "GIF8", 4) != 0) return loadImage(bufferPtr, bufferLength, width, height);
+  int channels;
+  return ImageBuffer(stbi_load_gif_from_memory(bufferPtr, bufferLength, nullptr, &width, &height, &frameCount, &channels, 1), stbi_image_free);
+}
+
+int reductionScale(int width, int height, const ZXing::ReaderOptions &readerOptions) {
+  if (!readerOptions.tryDownscale() || readerOptions.downscaleThreshold() <= 0) return 1;
+  const int target = readerOptions.downscaleThreshold() * std::max<int>(readerOptions.downscaleFactor(), 1);
+  return std::max(std::min(width, height) / target, 1);
+}
+
+// Every reduced row only depends on source rows that come after it, so the rows are written over the ones
+// already consumed.
+void reduceLuma(uint8_t *pixels, int width, int height, int scale) {
+  const int reducedWidth = width / scale, reducedHeight = height / scale, area = scale * scale;
+  std::vector<uint32_t> sums(reducedWidth);
+  for (int y = 0; y < reducedHeight; ++y) {
+    std::fill(sums.begin(), sums.end(), 0);
+    for (int dy = 0; dy < scale; ++dy) {
+      const uint8_t *row = pixels + static_cast<std::size_t>(y * scale + dy) * width;
+      for (int x = 0; x < reducedWidth; ++x)
+        for (int dx = 0; dx < scale; ++dx)
+          sums[x] += row[x * scale + dx];
+    }
+    uint8_t *reducedRow = pixels + static_cast<std::size_t>(y) * reducedWidth;
+    for (int x = 0; x < reducedWidth; ++x)
+      reducedRow[x] = static_cast<uint8_t>((sums[x] + area / 2) / area);
+  }
+}
+
+int reduceImage(ImageBuffer &image, int &width, int &height, const ZXing::ReaderOptions &readerOptions) {
+  const int scale = reductionScale(width, height, readerOptions);
+  if (scale == 1) return 1;
+  reduceLuma(image.get(), width, height, scale);
+  const std::size_t size = static_cast<std::size_t>(width) * height;
+  width /= scale;
+  height /= scale;
+  if (void *reduced = decodeRealloc(image.get(), size, static_cast<std::size_t>(width) * height)) {
+    image.release();
+    image.reset(static_cast<uint8_t *>(reduced));
+  }
+  return scale;
+}
+
+Rects reduceRegions(const Rects &regions, int scale) {
+  if (scale == 1) return regions;
+  Rects reduced;
+  reduced.reserve(regions.size());
+  for (const auto &region : regions) {
+    int left = region.x / scale, top = region.y / scale;
+    int right = (region.x + region.width + scale - 1) / scale, bottom = (region.y + region.height + scale - 1) / scale;
+    reduced.push_back({left, top, right - left, bottom - top});
+  }
+  return reduced;
+}
+
+ZXing::Barcodes enlargePositions(ZXing::Barcodes barcodes, int scale) {
+  if (scale == 1) return barcodes;
+  for (auto &barcode : barcodes) {
+    auto position = barcode.position();
+    for (auto &point : position) {
+      point.x *= scale;
+      point.y *= scale;
+    }
+    barcode.setPosition(position);
+  }
+  return barcodes;
+}
+
+ZXing::Barcodes readReducedImage(const ZXing::ImageView &imageView, int scale, const ReaderConfig &config) {
+  return enlargePositions(readCascade(imageView, config, reduceRegions(config.regions, scale)), scale);
+}
+
+// Both paths yield the same luma plane. The SIMD build converts 16 pixels per iteration.
+void rgbaToLuma(const uint8_t *rgba, std::size_t pixelCount, uint8_t *luma) {
+  std::size_t i = 0;
+#if defined(__wasm_simd128__)
+  const v128_t mask = wasm_i32x4_splat(0xFF);
+  const v128_t rWeight = wasm_i32x4_splat(306);
+  const v128_t gWeight = wasm_i32x4_splat(601);
+  const v128_t bWeight = wasm_i32x4_splat(117);
+  const v128_t rounding = wasm_i32x4_splat(0x200);
+  // One 32-bit lane per pixel, R in the lowest byte
+  auto luma4 = [&](const uint8_t *pixels) {
+    v128_t v = wasm_v128_load(pixels);
+    v128_t r = wasm_i32x4_mul(wasm_v128_and(v, mask), rWeight);
+    v128_t g = wasm_i32x4_mul(wasm_v128_and(wasm_u32x4_shr(v, 8), mask), gWeight);
+    v128_t b = wasm_i32x4_mul(wasm_v128_and(wasm_u32x4_shr(v, 16), mask), bWeight);
+    return wasm_u32x4_shr(wasm_i32x4_add(wasm_i32x4_add(r, g), wasm_i32x4_add(b, rounding)), 10);
+  };
+  for (; i + 16 <= pixelCount; i += 16) {
+    const uint8_t *pixels = rgba + 4 * i;
+    v128_t low = wasm_u16x8_narrow_i32x4(luma4(pixels), luma4(pixels + 16));
+    v128_t high = wasm_u16x8_narrow_i32x4(luma4(pixels + 32), luma4(pixels + 48));
+    wasm_v128_store(luma + i, wasm_u8x16_narrow_i16x8(low, high));
+  }
+#endif
+  for (; i < pixelCount; ++i) {
+    const uint8_t *pixel = rgba + 4 * i;
+    luma[i] = static_cast<uint8_t>((306 * pixel[0] + 601 * pixel[1] + 117 * pixel[2] + 0x200) >> 10);
+  }
+}
+
+ZXing::ImageView pixmapView(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &scratch) {
+#if defined(__wasm_simd128__)
+  if (width > 0 && height > 0) {
+    scratch.resize(static_cast<std::size_t>(width) * height);
+    rgbaToLuma(rgba, scratch.size(), scratch.data());
+    return {scratch.data(), width, height, ZXing::ImageFormat::Lum};
+  }
+#endif
+  return {rgba, width, height, ZXing::ImageFormat::RGBA};
+}
+
+thread_local std::vector<uint8_t> pixmapLuma;
+
+// ------------------ Batch reading ------------------
+namespace {
+
+  // The arenas of one batch call. Every image borrows one for its decode and hands it back afterwards, so the
+  // images read one after another share a block, and every block is freed when the call returns.
+  class DecodeArenaPool {
+  public:
+    std::unique_ptr<DecodeArena> acquire() {
+#if defined(SCANX_THREADS)
+      std::lock_guard<std::mutex> lock(mutex);
+#endif
+      if (idle.empty()) return std::make_unique<DecodeArena>();
+      auto arena = std::move(idle.back());
+      idle.pop_back();
+      return arena;
+    }
+
+    void restore(std::unique_ptr<DecodeArena> arena) {
+#if defined(SCANX_THREADS)
+      std::lock_guard<std::mutex> lock(mutex);
+#endif
+      idle.push_back(std::move(arena));
+    }
+
+  private:
+#if defined(SCANX_THREADS)
+    std::mutex mutex;
+#endif
+    std::vector<std::unique_ptr<DecodeArena>> idle;
+  };
+
+} // anonymous namespace
+
+void BatchReader::begin(int fields) {
+  readProfiler.begin(false);
+  packedReadResults.clear();
+  packedReadResults.setFields(fields);
+  index.assign(1, 0);
+  tiers.clear();
+  flags.clear();
+}
+
+void BatchReader::append(const ImageResult &image) {
+  if (image.status == 200) {
+    readerStats.add(image.barcodes, image.readMs);
+    appendResults(packedReadResults, image.barcodes);
+  } else {
+    appendError(packedReadResults, image.error, image.message, image.status);
+  }
+  index.push_back(static_cast<int32_t>(packedReadResults.size()));
+  tiers.push_back(image.cascadeTier);
+  flags.push_back(image.budgetExceeded ? PackedBudgetExceeded : 0);
+}
+
+const std::vector<uint8_t> &BatchReader::pack() {
+  index[0] = static_cast<int32_t>(tiers.size());
+  index.insert(index.end(), tiers.begin(), tiers.end());
+  index.insert(index.end(), flags.begin(), flags.end());
+  return packedReadResults.pack(index);
+}
+
+const std::vector<uint8_t> &BatchReader::read(const uint8_t *inputs, const int32_t *offsets, int count, const ReaderConfig &config, int fields) {
+  begin(fields);
+
+  AuthResponse auth = isAccessTokenIsValidToday(config.accessToken);
+  if (auth.status == 200) {
+    DecodeArenaPool arenas;
+    auto images = parallelMap(count, [&](int i) {
+      auto arena = arenas.acquire();
+      ImageResult image = readImage(inputs + offsets[i], offsets[i + 1] - offsets[i], config, *arena);
+      arenas.restore(std::move(arena));
+      return image;
+    });
+    for (const auto &image : images)
+      append(image);
+  } else {
+    for (int i = 0; i < count; ++i)
+      append({.error = statusToMessage(auth.status), .message = statusToMessage(auth.status), .status = auth.status});
+  }
+  return pack();
+}
+
+const std::vector<uint8_t> &BatchReader::readFrames(
+  const uint8_t *bufferPtr, int bufferLength, const ReaderConfig &config, int fields, bool stopAtFirstCode
+) {
+  begin(fields);
+
+  AuthResponse auth = isAccessTokenIsValidToday(config.accessToken);
+  if (auth.status != 200) {
+    append({.error = statusToMessage(auth.status), .message = statusToMessage(auth.status), .status = auth.status});
+    return pack();
+  }
+
+  DecodeArena arena;
+  DecodeArenaScope arenaScope(arena);
+  int width, height, frameCount;
+  auto frames = loadFrames(bufferPtr, bufferLength, width, height, frameCount);
+  if (!frames) {
+    append({.error = "Failed to load image from memory", .status = 0});
+  } else {
+    const std::size_t frameSize = static_cast<std::size_t>(width) * height;
+    const int scale = config.downscaleOnDecode ? reductionScale(width, height, config.readerOptions) : 1;
+    for (int i = 0; i < frameCount; ++i) {
+      uint8_t *frame = frames.get() + i * frameSize;
+      if (scale > 1) reduceLuma(frame, width, height, scale);
+      ImageResult image = readLuma(frame, width / scale, height / scale, scale, config);
+      append(image);
+      auto isValid = [](const ZXing::Barcode &barcode) { return barcode.isValid(); };
+      if (stopAtFirstCode && std::any_of(image.barcodes.begin(), image.barcodes.end(), isValid)) break;
+    }
+  }
+  return pack();
+}
+
+BatchReader::ImageResult BatchReader::readLuma(const uint8_t *pixels, int width, int height, int scale, const ReaderConfig &config) {
+  ImageResult result;
+  try {
+    auto start = Clock::now();
+    cascadeTier = -1;
+    readBudget.begin(config.timeBudgetMs);
+    result.barcodes = readReducedImage({pixels, width, height, ZXing::ImageFormat::Lum}, scale, config);
+    result.readMs = elapsedMs(start);
+    result.cascadeTier = cascadeTier;
+    result.budgetExceeded = readBudget.exceeded;
+  } catch (const std::exception &e) {
+    result = {.error = e.what(), .message = "try again", .status = 403};
+  } catch (...) {
+    result = {.error = "Unknown error", .message = "try again", .status = 403};
+  }
+  return result;
+}
+
+BatchReader::ImageResult BatchReader::readImage(const uint8_t *bufferPtr, int bufferLength, const ReaderConfig &config) {
+  DecodeArena arena;
+  return readImage(bufferPtr, bufferLength, config, arena);
+}
+
+BatchReader::ImageResult BatchReader::readImage(const uint8_t *bufferPtr, int bufferLength, const ReaderConfig &config, DecodeArena &arena) {
+  DecodeArenaScope arenaScope(arena);
+  int width, height;
+  auto image = loadImage(bufferPtr, bufferLength, width, height);
+  if (!image) return {.error = "Failed to load image from memory", .status = 0};
+  int scale = config.downscaleOnDecode ? reduceImage(image, width, height, config.readerOptions) : 1;
+  return readLuma(image.get(), width, height, scale, config);
+}
+
+// ------------------ Tracking ------------------
+ZXing::Barcodes BarcodeTracker::read(const ZXing::ImageView &imageView, const ReaderConfig &config, const Rects &regions) {
+  trackIds.clear();
+  if (!enabled()) return readCascade(imageView, config, regions);
+
+  ZXing::Barcodes barcodes;
+  bool tracked = false;
+  const bool windowed = !tracks.empty() && ++framesSinceFullScan < fullScanInterval;
+  if (windowed) {
+    barcodes = readCascade(imageView, config, windows());
+    tracked = barcodes.size() >= tracks.size();
+  }
+  // After the windows, a full scan past the deadline is left to the next frame
+  if (!tracked && (!windowed || readBudget.allowsNextPass())) {
+    cascadeTier = -1;
+    barcodes = readCascade(imageView, config, regions);
+    framesSinceFullScan = 0;
+  }
+  update(barcodes);
+  return barcodes;
+}
+
+// The bounding box of a barcode, grown by half its size on every side
+Rect BarcodeTracker::window(const ZXing::Position &position) {
+  int left = position[0].x, top = position[0].y, right = left, bottom = top;
+  for (const auto &point : position) {
+    left = std::min(left, point.x);
+    top = std::min(top, point.y);
+    right = std::max(right, point.x);
+    bottom = std::max(bottom, point.y);
+  }
+  const int margin = std::max({right - left, bottom - top, kMinWindowSize}) / 2;
+  return {left - margin, top - margin, right - left + 2 * margin, bottom - top + 2 * margin};
+}
+
+Rects BarcodeTracker::windows() const {
+  Rects rects;
+  for (const auto &track : tracks)
+    rects.push_back(window(track.barcode.position()));
+  return rects;
+}
+
+// Same content and a center that stayed within the tracking window
+bool BarcodeTracker::isSameTrack(const ZXing::Barcode &previous, const ZXing::Barcode &barcode) {
+  if (previous.format() != barcode.format() || previous.bytes() != barcode.bytes()) return false;
+  Rect rect = window(previous.position());
+  auto c = center(barcode.position());
+  return c.x >= rect.x && c.x <= rect.x + rect.width && c.y >= rect.y && c.y <= rect.y + rect.height;
+}
+
+void BarcodeTracker::update(const ZXing::Barcodes &barcodes) {
+  std::vector<Track> next;
+  for (const auto &barcode : barcodes) {
+    auto match = std::find_if(tracks.begin(), tracks.end(), [&](const Track &track) {
+      return track.id >= 0 && isSameTrack(track.barcode, barcode);
+    });
+    int32_t id;
+    if (match != tracks.end()) {
+      id = match->id;
+      match->id = -1; // a track continues with one barcode only
+    } else {
+      id = nextId++;
+    }
+    next.push_back({barcode, id});
+    trackIds.push_back(id);
+  }
+  tracks = std::move(next);
+}
+
+// ------------------ Change detection ------------------
+bool ChangeDetector::unchanged(const ZXing::ImageView &imageView) {
+  if (imageView.width() <= 0 || imageView.height() <= 0) return false;
+  ++counters.frames;
+  candidate = fingerprint(imageView);
+  candidateWidth = imageView.width();
+  candidateHeight = imageView.height();
+  if (!hasReference || candidateWidth != width || candidateHeight != height) return false;
+
+  int difference = 0;
+  for (std::size_t i = 0; i < candidate.size(); ++i)
+    difference += std::abs(candidate[i] - reference[i]);
+  if (difference >= threshold * static_cast<double>(candidate.size())) return false;
+  ++counters.skipped;
+  return true;
+}
+
+// Block means of the luma, or of the green channel of a color image, each from a few evenly spaced samples
+ChangeDetector::Fingerprint ChangeDetector::fingerprint(const ZXing::ImageView &imageView) {
+  constexpr int samples = kGridSize * kSamplesPerBlock;
+  const int channel = ZXing::GreenIndex(imageView.format());
+  std::array<int, samples> xs;
+  for (int i = 0; i < samples; ++i)
+    xs[i] = static_cast<int>((2 * i + 1) * static_cast<int64_t>(imageView.width()) / (2 * samples));
+
+  std::array<int, kGridSize * kGridSize> sums{};
+  for (int j = 0; j < samples; ++j) {
+    const int y = static_cast<int>((2 * j + 1) * static_cast<int64_t>(imageView.height()) / (2 * samples));
+    auto *sum = &sums[j / kSamplesPerBlock * kGridSize];
+    for (int i = 0; i < samples; ++i)
+      sum[i / kSamplesPerBlock] += imageView.data(xs[i], y)[channel];
+  }
+
+  Fingerprint result;
+  for (std::size_t i = 0; i < result.size(); ++i)
+    result[i] = static_cast<uint8_t>(sums[i] / (kSamplesPerBlock * kSamplesPerBlock));
+  return result;
+}
+
+#endif
+
+#if defined(WRITER)
+
+ZXing::CreatorOptions createCreatorOptions(const WriterConfig &config) {
+  return ZXing::CreatorOptions(static_cast<ZXing::BarcodeFormat>(config.format))
+    .readerInit(config.readerInit)
+    .ecLevel(config.ecLevel)
+    .options(config.options);
+}
+
+ZXing::WriterOptions createWriterOptions(const WriterConfig &config) {
+  return ZXing::WriterOptions()
+    .scale(config.scale)
+    .sizeHint(config.sizeHint)
+    .rotate(config.rotate)
+    .withHRT(config.withHRT)
+    .withQuietZones(config.withQuietZones);
+}
+
+void appendPNG(const ZXing::Image &image, int compressionLevel, std::vector<uint8_t> &data) {
+  stbi_write_png_compression_level = compressionLevel;
+  // Encode straight into `data` instead of a malloc'ed PNG buffer
+  stbi_write_png_to_func(
+    [](void *context, void *bytes, int size) {
+      auto &data = *static_cast<std::vector<uint8_t> *>(context);
+      data.insert(data.end(), static_cast<uint8_t *>(bytes), static_cast<uint8_t *>(bytes) + size);
+    },
+    &data,
+    image.width(),
+    image.height(),
+    ZXing::PixStride(image.format()),
+    image.data(),
+    image.rowStride()
+  );
+}
+
+void copyPixmap(const ZXing::Image &image, int channels, uint8_t *pixmap) {
+  const std::size_t rowSize = static_cast<std::size_t>(image.width()) * channels;
+  for (int y = 0; y < image.height(); ++y) {
+    const uint8_t *src = image.data(0, y);
+    uint8_t *dst = pixmap + y * rowSize;
+    for (int x = 0; x < image.width(); ++x, src += image.pixStride()) {
+      if (channels == 1) {
+        dst[x] = *src;
+      } else {
+        dst[4 * x] = dst[4 * x + 1] = dst[4 * x + 2] = *src;
+        dst[4 * x + 3] = 0xff;
+      }
+    }
+  }
+}
+
+// ------------------ Write cache ------------------
+WrittenBarcode writeOutputs(const ZXing::Barcode &barcode, const ZXing::WriterOptions &writerOptions, const WriterConfig &config) {
+  WrittenBarcode written;
+  auto &[entry, data] = written;
+  auto append = [&data](const void *bytes, std::size_t length) {
+    PackedSpan span{static_cast<int32_t>(data.size()), static_cast<int32_t>(length)};
+    data.insert(data.end(), static_cast<const uint8_t *>(bytes), static_cast<const uint8_t *>(bytes) + length);
+    return span;
+  };
+
+  const int outputs = config.outputs;
+  if (outputs & (WritePNG | WritePixmap)) {
+    auto image = ZXing::WriteBarcodeToImage(barcode, writerOptions);
+    if (outputs & WritePNG) {
+      entry.png.offset = static_cast<int32_t>(data.size());
+      appendPNG(image, config.pngCompressionLevel, data);
+      entry.png.length = static_cast<int32_t>(data.size()) - entry.png.offset;
+    }
+    if (outputs & WritePixmap) {
+      const int channels = config.pixmapFormat == PixmapRGBA ? 4 : 1;
+      const std::size_t size = static_cast<std::size_t>(image.width()) * image.height() * channels;
+      entry.pixmap = {static_cast<int32_t>(data.size()), static_cast<int32_t>(size)};
+      data.resize(data.size() + size);
+      copyPixmap(image, channels, data.data() + entry.pixmap.offset);
+      entry.pixmapWidth = image.width();
+      entry.pixmapHeight = image.height();
+    }
+  }
+  if (outputs & WriteSVG) {
+    auto svg = ZXing::WriteBarcodeToSVG(barcode, writerOptions);
+    entry.svg = append(svg.data(), svg.size());
+  }
+  if (outputs & WriteUtf8) {
+    auto utf8 = ZXing::WriteBarcodeToUtf8(barcode, writerOptions);
+    entry.utf8 = append(utf8.data(), utf8.size());
+  }
+  if (outputs & WriteSymbol) {
+    auto symbol = barcode.symbol();
+    entry.symbol = {static_cast<int32_t>(data.size()), symbol.width() * symbol.height()};
+    for (int y = 0; y < symbol.height(); ++y)
+      append(symbol.data(0, y), symbol.width());
+    entry.symbolWidth = symbol.width();
+    entry.symbolHeight = symbol.height();
+  }
+  return written;
+}
+
+WrittenBarcode writePayload(
+  const char *payload,
+  int length,
+  bool isText,
+  const WriterConfig &config,
+  const ZXing::CreatorOptions &creatorOptions,
+  const ZXing::WriterOptions &writerOptions
+) {
+  auto barcode = isText ? ZXing::CreateBarcodeFromText(std::string_view(payload, length), creatorOptions)
+                        : ZXing::CreateBarcodeFromBytes(payload, length, creatorOptions);
+  return writeOutputs(barcode, writerOptions, config);
+}
+
+WriteCache writeCache;
+
+// Every field of the config that changes the outputs, followed by the payload. The pixmap buffer of the
+// caller is not part of it, cached pixmaps are copied into whichever buffer the next write asks for.
+std::string WriteCache::key(const char *payload, int length, bool isText, const WriterConfig &config) {
+  const int32_t fields[] = {
+    isText,
+    config.format,
+    config.readerInit,
+    config.scale,
+    config.sizeHint,
+    config.rotate,
+    config.withHRT,
+    config.withQuietZones,
+    config.outputs,
+    config.pngCompressionLevel,
+    config.pixmapFormat,
+    static_cast<int32_t>(config.ecLevel.size()),
+    static_cast<int32_t>(config.options.size()),
+  };
+  std::string key(reinterpret_cast<const char *>(fields), sizeof(fields));
+  key.reserve(key.size() + config.ecLevel.size() + config.options.size() + length);
+  key.append(config.ecLevel).append(config.options).append(payload, length);
+  return key;
+}
+
+// The key is held twice, by the entry and by the index
+std::size_t WriteCache::cost(const Entry &entry) {
+  return 2 * entry.first.size() + entry.second.data.size() + sizeof(Entry);
+}
+
+const WrittenBarcode &WriteCache::write(
+  const char *payload,
+  int length,
+  bool isText,
+  const WriterConfig &config,
+  const ZXing::CreatorOptions &creatorOptions,
+  const ZXing::WriterOptions &writerOptions
+) {
+  auto create = [&] { return writePayload(payload, length, isText, config, creatorOptions, writerOptions); };
+  if (!capacity) {
+    uncached = create();
+    return uncached;
+  }
+
+  std::string entryKey = key(payload, length, isText, config);
+  if (auto it = index.find(entryKey); it != index.end()) {
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+  }
+
+  ++misses;
+  Entry entry{std::move(entryKey), create()};
+  const std::size_t entryCost = cost(entry);
+  if (entryCost > capacity) {
+    uncached = std::move(entry.second);
+    return uncached;
+  }
+  evict(capacity - entryCost);
+  entries.push_front(std::move(entry));
+  index.emplace(entries.front().first, entries.begin());
+  bytes += entryCost;
+  return entries.front().second;
+}
+
+// Drops the least recently used entries until at most `limit` bytes are left
+void WriteCache::evict(std::size_t limit) {
+  while (bytes > limit && !entries.empty()) {
+    bytes -= cost(entries.back());
+    index.erase(entries.back().first);
+    entries.pop_back();
+  }
+}
+
+void WriteCache::setCapacity(std::size_t newCapacity) {
+  capacity = newCapacity;
+  evict(capacity);
+}
+
+void WriteCache::purge() {
+  index.clear();
+  entries.clear();
+  uncached = {};
+  bytes = 0;
+  hits = 0;
+  misses = 0;
+}
+
+WriteCache::Stats WriteCache::stats() const {
+  return {
+    .hits = hits,
+    .misses = misses,
+    .entries = static_cast<double>(entries.size()),
+    .bytes = static_cast<double>(bytes),
+    .capacity = static_cast<double>(capacity),
+  };
+}
+
+// ------------------ Batch writer ------------------
+const std::vector<uint8_t> &BatchWriter::write(
+  const uint8_t *inputs, const int32_t *offsets, const uint8_t *isText, int count, const WriterConfig &config
+) {
+  entries.assign(count, {});
+  data.clear();
+
+  try {
+    auto creatorOptions = createCreatorOptions(config);
+    auto writerOptions = createWriterOptions(config);
+
+    for (int i = 0; i < count; ++i) {
+      const char *input = reinterpret_cast<const char *>(inputs) + offsets[i];
+      const int length = offsets[i + 1] - offsets[i];
+      try {
+        const auto written = writePayload(input, length, isText[i] != 0, config, creatorOptions, writerOptions);
+        // The spans are relative to the outputs of this entry, move them behind those of the previous entries
+        const auto base = static_cast<int32_t>(data.size());
+        entries[i] = written.entry;
+        for (PackedSpan *span : {&entries[i].png, &entries[i].svg, &entries[i].utf8, &entries[i].symbol, &entries[i].pixmap})
+          span->offset += base;
+        data.insert(data.end(), written.data.begin(), written.data.end());
+      } catch (const std::exception &e) {
+        entries[i] = {.error = append(e.what(), std::strlen(e.what()))};
+      } catch (...) {
+        entries[i] = {.error = append("Unknown error", 13)};
+      }
+    }
+  } catch (const std::exception &e) {
+    // Invalid shared options fail every entry the same way
+    for (auto &entry : entries)
+      entry = {.error = append(e.what(), std::strlen(e.what()))};
+  }
+
+  const std::size_t tableSize = kHeaderSize + entries.size() * sizeof(PackedWriteEntry);
+  buffer.resize(tableSize + data.size());
+  int32_t header[2] = {count, sizeof(PackedWriteEntry)};
+  std::memcpy(buffer.data(), header, kHeaderSize);
+  std::memcpy(buffer.data() + kHeaderSize, entries.data(), entries.size() * sizeof(PackedWriteEntry));
+  std::memcpy(buffer.data() + tableSize, data.data(), data.size());
+  return buffer;
+}
+
+PackedSpan BatchWriter::append(const void *bytes, std::size_t length) {
+  PackedSpan span{static_cast<int32_t>(data.size()), static_cast<int32_t>(length)};
+  data.insert(data.end(), static_cast<const uint8_t *>(bytes), static_cast<const uint8_t *>(bytes) + length);
+  return span;
+}
+
+#endif
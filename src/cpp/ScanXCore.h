@@ -0,0 +1,959 @@
+/*
+ * Copyright 2016 Nu-book Inc.
+ * Copyright 2023 Axel Waggershauser
+ * Copyright 2023 Ze-Zheng Wu
+ */
+// SPDX-License-Identifier: Apache-2.0
+
+// The reading and writing logic shared by the WASM modules (ScanXWasm.cpp, which only adds the embind glue)
+// and the native library and CLI (ScanXCli.cpp). Nothing in here depends on emscripten, so the exact same
+// code paths can be built for Linux to run batch jobs natively or to profile them under perf.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// The multithreaded WASM build (TARGET=READER_MT) and native builds read on a thread pool, see ThreadPool
+#if defined(__EMSCRIPTEN_PTHREADS__) || !defined(__EMSCRIPTEN__)
+  #define SCANX_THREADS
+#endif
+
+#if defined(SCANX_THREADS)
+  #include <condition_variable>
+  #include <functional>
+  #include <future>
+  #include <mutex>
+  #include <queue>
+  #include <thread>
+#endif
+
+// (offset, length) of a variable length field, relative to the start of the packed data section
+struct PackedSpan {
+  int32_t offset;
+  int32_t length;
+};
+
+#if defined(READER)
+  #include "ReadBarcode.h"
+
+struct Rect {
+  int x;
+  int y;
+  int width;
+  int height;
+};
+
+using Rects = std::vector<Rect>;
+
+// Everything a read needs besides the pixels, converted once from the options of the caller (JS or command line)
+struct ReaderConfig {
+  ZXing::ReaderOptions readerOptions;
+  Rects regions; // empty to read the whole image
+  std::vector<ZXing::ReaderOptions> cascade; // option tiers to read with instead of readerOptions, see readCascade
+  bool downscaleOnDecode = false;
+  std::size_t tileMemoryLimit = 0; // bytes, 0 reads the image in one piece, see tileImage
+  int tileOverlap = 256; // pixels shared by neighbouring tiles
+  double timeBudgetMs = 0; // per image, 0 reads without a deadline, see ReadBudget
+  bool profile = false; // record the stage timings of every read, see ReadProfiler
+  std::string accessToken;
+};
+
+// ------------------ Access token ------------------
+struct AuthResponse {
+  int status; // Status code
+};
+
+std::string statusToMessage(const int &status);
+
+// The verdict only depends on the token and the local date, so it is computed once and reused until
+// the date changes (or the clock is set back before the day it was computed on).
+AuthResponse isAccessTokenIsValidToday(const std::string &accessToken);
+
+// ------------------ Threading ------------------
+#if defined(SCANX_THREADS)
+// A fixed set of worker threads. The multithreaded WASM build starts them from the pool of web workers emscripten
+// spawns up front, so there kMaxThreads must not exceed PTHREAD_POOL_SIZE. Native builds use every core.
+class ThreadPool {
+public:
+  static constexpr unsigned kMaxThreads = 4;
+
+  // The pool is started with `size` workers on first use, later calls get the same pool whatever they pass
+  static ThreadPool &instance(unsigned size = defaultSize()) {
+    static ThreadPool threadPool(std::max(size, 1u));
+    return threadPool;
+  }
+
+  static unsigned defaultSize() {
+#if defined(__EMSCRIPTEN__)
+    return std::clamp(std::thread::hardware_concurrency(), 1u, kMaxThreads);
+#else
+    return std::max(std::thread::hardware_concurrency(), 1u);
+#endif
+  }
+
+  // Tasks submitted from a worker would wait on tasks queued behind them, so workers run nested work inline
+  static bool isWorkerThread() {
+    return isWorker;
+  }
+
+  unsigned size() const {
+    return static_cast<unsigned>(workers.size());
+  }
+
+  template <typename Task>
+  auto submit(Task task) -> std::future<decltype(task())> {
+    auto packagedTask = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+    auto future = packagedTask->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.emplace([packagedTask] { (*packagedTask)(); });
+    }
+    condition.notify_one();
+    return future;
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    condition.notify_all();
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+private:
+  explicit ThreadPool(unsigned size) {
+    for (unsigned i = 0; i < size; ++i)
+      workers.emplace_back([this] { run(); });
+  }
+
+  void run() {
+    isWorker = true;
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (tasks.empty()) return;
+        task = std::move(tasks.front());
+        tasks.pop();
+      }
+      task();
+    }
+  }
+
+  static inline thread_local bool isWorker = false;
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping = false;
+};
+#endif
+
+// Calls `task(0) ... task(count - 1)` and returns their results in order. Builds with a thread pool spread the
+// calls over it, every other build (and nested calls on a worker) simply runs them one by one.
+// Exceptions thrown by a task are rethrown here, once every task has finished, as the tasks refer to the caller's stack.
+template <typename Task>
+auto parallelMap(int count, Task task) -> std::vector<decltype(task(0))> {
+  std::vector<decltype(task(0))> results;
+  results.reserve(count);
+#if defined(SCANX_THREADS)
+  if (count > 1 && !ThreadPool::isWorkerThread()) {
+    std::vector<std::future<decltype(task(0))>> futures;
+    futures.reserve(count);
+    for (int i = 0; i < count; ++i)
+      futures.push_back(ThreadPool::instance().submit([&task, i] { return task(i); }));
+    for (auto &future : futures)
+      future.wait();
+    for (auto &future : futures)
+      results.push_back(future.get());
+    return results;
+  }
+#endif
+  for (int i = 0; i < count; ++i)
+    results.push_back(task(i));
+  return results;
+}
+
+// ------------------ Packed results ------------------
+// Bits of the `fields` mask of the packed read functions, selecting the optional fields to pack
+enum PackedField : int {
+  PackedBytes = 1 << 0,
+  PackedBytesECI = 1 << 1,
+  PackedSymbol = 1 << 2,
+  PackedExtra = 1 << 3,
+};
+
+// Fixed size part of a packed read result, all values are little endian int32
+struct PackedRecord {
+  int32_t status;
+  int32_t format;
+  int32_t contentType;
+  int32_t flags; // isValid | hasECI << 1 | isMirrored << 2 | isInverted << 3 | readerInit << 4
+  int32_t orientation;
+  int32_t sequenceSize;
+  int32_t sequenceIndex;
+  int32_t lineCount;
+  int32_t position[8]; // x, y of topLeft, topRight, bottomRight, bottomLeft
+  PackedSpan text;
+  PackedSpan error;
+  PackedSpan ecLevel;
+  PackedSpan symbologyIdentifier;
+  PackedSpan sequenceId;
+  PackedSpan version;
+  PackedSpan extra;
+  PackedSpan message;
+  PackedSpan bytes;
+  PackedSpan bytesECI;
+  PackedSpan symbol;
+  int32_t symbolWidth;
+  int32_t symbolHeight;
+};
+static_assert(sizeof(PackedRecord) == 160, "the packed layout is mirrored in src/bindings/packedReadResult.ts");
+
+// Read results packed into a single buffer, so they cross into JS as one copy instead of one embind
+// conversion per field. Layout: a header of two int32 (number of records, record size), the records,
+// then the data section holding the strings (utf8), bytes and symbol bitmaps the records point into.
+class PackedReadResults {
+public:
+  void clear() {
+    records.clear();
+    data.clear();
+  }
+
+  void setFields(int fields) {
+    this->fields = fields;
+  }
+
+  void add(const ZXing::Barcode &barcode);
+  void addError(const std::string &error, const std::string &message, int status);
+
+  std::size_t size() const {
+    return records.size();
+  }
+
+  // The packed buffer, only valid until the next read.
+  // `prefix` is written in front of the header, batch reads store their per-image index there.
+  const std::vector<uint8_t> &pack(const std::vector<int32_t> &prefix = {});
+
+private:
+  static constexpr std::size_t kHeaderSize = 2 * sizeof(int32_t);
+
+  PackedSpan append(const void *bytes, std::size_t length);
+
+  PackedSpan append(const std::string &string) {
+    return append(string.data(), string.size());
+  }
+
+  int fields = ~0;
+  std::vector<PackedRecord> records;
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> buffer;
+};
+
+// Every read path below fills its result container through these two overloads. The embind glue adds the
+// overloads for its value_object results.
+void appendResults(PackedReadResults &packedReadResults, const ZXing::Barcodes &barcodes);
+void appendError(PackedReadResults &packedReadResults, const std::string &error, const std::string &message, int status);
+
+// ------------------ Profiling ------------------
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start);
+
+// Counts the allocations of stb_image for the reader stats, and every C++ allocation, ZXing's included, in
+// builds with SCANX_COUNT_ALLOCATIONS (the WASM modules), which replace the global operator new
+extern std::atomic<uint64_t> allocationCount;
+
+// Stage timings of a single read, in milliseconds
+struct ReadProfile {
+  double decodeMs;
+  double authMs;
+  double readMs;
+  double marshalMs;
+};
+
+// Records the stage timings of the current read while the reader options ask for it. Every read entry point
+// calls begin(), the stages add their time as they run, and the caller fetches the profile right after the call.
+class ReadProfiler {
+public:
+  void begin(bool enabled) {
+    this->enabled = enabled;
+    profile = {};
+  }
+
+  void add(double ReadProfile::*stage, double ms) {
+    if (enabled) profile.*stage += ms;
+  }
+
+  const ReadProfile &last() const {
+    return profile;
+  }
+
+private:
+  bool enabled = false;
+  ReadProfile profile{};
+};
+
+extern thread_local ReadProfiler readProfiler;
+
+// The deadline of the read running on this thread. ZXing cannot be interrupted inside a ReadBarcodes pass, so
+// the deadline is checked between the passes this file runs: cascade tiers, regions, tiles and the full scan
+// of the tracker. The first pass of a read always runs, every later one only while there is time left, and a
+// skipped pass flags the read as cut short. Reads without a budget never query the clock.
+struct ReadBudget {
+  static constexpr Clock::time_point kNoDeadline = Clock::time_point::max();
+
+  Clock::time_point deadline = kNoDeadline;
+  bool exceeded = false;
+
+  void begin(double timeBudgetMs) {
+    deadline = timeBudgetMs > 0
+                 ? Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(timeBudgetMs))
+                 : kNoDeadline;
+    exceeded = false;
+  }
+
+  static bool expired(Clock::time_point deadline) {
+    return deadline != kNoDeadline && Clock::now() >= deadline;
+  }
+
+  // Whether the next pass may run, flags the read as cut short if not
+  bool allowsNextPass() {
+    if (expired(deadline)) exceeded = true;
+    return !exceeded;
+  }
+};
+
+extern thread_local ReadBudget readBudget;
+
+// Cumulative counters over every read since the last reset, for telemetry.
+// Only updated from the thread that called into the reader, so the batch reader adds the stats of
+// its images after the parallel part is done.
+struct ReaderStats {
+  struct FormatStats {
+    double count = 0;
+    double readMs = 0;
+  };
+
+  void add(const ZXing::Barcodes &barcodes, double readMs);
+  void reset();
+
+  double calls = 0;
+  double heapHighWater = 0; // size of the WASM memory, not tracked by native builds
+  std::map<int, FormatStats> formats;
+};
+
+extern ReaderStats readerStats;
+
+// ------------------ Reading ------------------
+// ZXing::ReadBarcodes, but builds with a thread pool read the matrix and the linear formats concurrently when
+// splitFormatFamilies is set. Both families read the same binarized copy of the image.
+ZXing::Barcodes readFormatFamilies(const ZXing::ImageView &imageView, const ZXing::ReaderOptions &readerOptions);
+
+// The split waits for the pool on the calling thread. The glue clears this on the browser main thread, which
+// must not block, so reads from there stay on one thread. Workers and Node.js keep it set.
+extern bool splitFormatFamilies;
+
+// Reads every region of `imageView` in turn, or the whole image if `regions` is empty. Stops at the first region
+// past the deadline of the read, see ReadBudget.
+ZXing::Barcodes readBarcodes(const ZXing::ImageView &imageView, const ZXing::ReaderOptions &readerOptions, const Rects &regions);
+
+// Two results describe the same symbol if they carry the same content and their centers
+// are closer than half the extent of the first one, e.g. when read from overlapping regions.
+bool isSameSymbol(const ZXing::Barcode &a, const ZXing::Barcode &b);
+
+// Splits a `width` x `height` image into a grid of tiles overlapping by `config.tileOverlap` pixels, each as large as
+// `config.tileMemoryLimit` allows with as many tiles read at once as there are workers. Empty if the whole image
+// fits into the limit, or if there is no limit. Tiles never exceed the limit, a small limit shrinks the overlap
+// below half the tile side instead.
+Rects tileImage(int width, int height, const ReaderConfig &config);
+
+// Reads every tile of `imageView`, on the thread pool where there is one, and merges the results in tile order.
+// A symbol read again by an overlapping tile is only returned once, with the position from the first tile.
+// Tiles that would start past the deadline of the read are skipped, see ReadBudget.
+ZXing::Barcodes readTiles(const ZXing::ImageView &imageView, const ZXing::ReaderOptions &readerOptions, const Rects &tiles);
+
+// Reads with every tier of `config.cascade` in turn on the same image and stops at the first tier that finds a
+// valid barcode, or reads once with `config.readerOptions` if there is no cascade. If no tier finds a valid
+// barcode, the results of the last tier are returned (these can only be errors, see returnErrors).
+// Without `regions`, images beyond `config.tileMemoryLimit` are read in tiles, see tileImage.
+ZXing::Barcodes readCascade(const ZXing::ImageView &imageView, const ReaderConfig &config, const Rects &regions);
+
+// Index of the cascade tier that produced the results of the last read on this thread, -1 if none did
+extern thread_local int cascadeTier;
+
+// Called by every read entry point before reading.
+inline void beginRead(const ReaderConfig &config) {
+  readProfiler.begin(config.profile);
+  readBudget.begin(config.timeBudgetMs);
+  cascadeTier = -1;
+}
+
+// Appends the barcodes returned by `read()` to `results`. Results `reused` from an earlier read are left out of
+// the reader stats, the flag is only looked at once `read()` returned, so the read itself may set it.
+// On failure the partial results are dropped and a single error entry is left instead.
+template <typename Results, typename Read>
+void appendRead(Read read, Results &results, const bool &reused = false) {
+  try {
+    auto start = Clock::now();
+    auto barcodes = read();
+    const double readMs = elapsedMs(start);
+    readProfiler.add(&ReadProfile::readMs, readMs);
+    if (!reused) readerStats.add(barcodes, readMs);
+    start = Clock::now();
+    appendResults(results, barcodes);
+    readProfiler.add(&ReadProfile::marshalMs, elapsedMs(start));
+  } catch (const std::exception &e) {
+    results.clear();
+    appendError(results, e.what(), "try again", 403);
+  } catch (...) {
+    results.clear();
+    appendError(results, "Unknown error", "try again", 403);
+  }
+}
+
+// Checks the access token before reading, an invalid token leaves a single error entry instead.
+template <typename Results, typename Read>
+void appendAuthorizedRead(const std::string &accessToken, Read read, Results &results, const bool &reused = false) {
+  auto start = Clock::now();
+  AuthResponse dateRes = isAccessTokenIsValidToday(accessToken);
+  readProfiler.add(&ReadProfile::authMs, elapsedMs(start));
+  if (dateRes.status == 200) {
+    appendRead(read, results, reused);
+  } else {
+    appendError(results, statusToMessage(dateRes.status), statusToMessage(dateRes.status), dateRes.status);
+  }
+}
+
+// ------------------ Decoding ------------------
+// stb_image allocates through these hooks, so batch reads can hand it a reused scratch arena (see DecodeArena)
+void *decodeMalloc(std::size_t size);
+void *decodeRealloc(void *ptr, std::size_t oldSize, std::size_t newSize);
+void decodeFree(void *ptr);
+
+// Scratch memory for stb_image while a batch of images is decoded. Allocations are bumped out of one
+// block that is reset between images instead of going back to malloc. Whatever does not fit is
+// malloc'ed as usual, and the block grows by that much on the next reset, so after the first few
+// images of a batch every decode runs out of the same block. The block is freed with the arena at the end
+// of the batch and never grows past kMaxCapacity, larger images keep part of their decode on malloc instead.
+class DecodeArena {
+public:
+  DecodeArena() = default;
+  DecodeArena(const DecodeArena &) = delete;
+  DecodeArena &operator=(const DecodeArena &) = delete;
+
+  ~DecodeArena() {
+    reset();
+    std::free(block);
+  }
+
+  void *allocate(std::size_t size);
+  void *reallocate(void *ptr, std::size_t oldSize, std::size_t newSize);
+  void release(void *ptr);
+
+  // Drops every allocation of the current image, nothing handed out before may be used afterwards.
+  void reset();
+
+private:
+  // Enough for a 4K frame, bounds what every thread decoding a batch image holds while the batch is read
+  static constexpr std::size_t kMaxCapacity = 64 << 20;
+
+  static std::size_t align(std::size_t size) {
+    return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+  }
+
+  bool owns(const void *ptr) const {
+    return ptr >= block && ptr < block + capacity;
+  }
+
+  uint8_t *block = nullptr;
+  std::size_t capacity = 0;
+  std::size_t used = 0;
+  std::size_t last = 0;
+  std::vector<void *> overflow;
+  std::size_t overflowSize = 0;
+};
+
+// The arena stb_image allocates from, null outside of batch reads
+extern thread_local DecodeArena *decodeArena;
+
+// Points decodeArena at `arena` for the lifetime of the scope. On leaving it, however that happens, the arena
+// is reset and the previous one restored. Images decoded into the arena must be freed before.
+class DecodeArenaScope {
+public:
+  explicit DecodeArenaScope(DecodeArena &arena) : arena(arena), previous(decodeArena) {
+    decodeArena = &arena;
+  }
+  DecodeArenaScope(const DecodeArenaScope &) = delete;
+  DecodeArenaScope &operator=(const DecodeArenaScope &) = delete;
+
+  ~DecodeArenaScope() {
+    arena.reset();
+    decodeArena = previous;
+  }
+
+private:
+  DecodeArena &arena;
+  DecodeArena *previous;
+};
+
+using ImageBuffer = std::unique_ptr<uint8_t, void (*)(void *)>;
+
+// Decodes an encoded image (PNG, JPEG, ...) into a single-channel luma image.
+ImageBuffer loadImage(const uint8_t *bufferPtr, int bufferLength, int &width, int &height);
+
+// Decodes every frame of an animated GIF into `frameCount` luma images of `width` x `height` stored back to back,
+// each one fully composed (stb applies the disposal of the previous frames). Other formats are decoded like
+// loadImage, as a single frame.
+ImageBuffer loadFrames(const uint8_t *bufferPtr, int bufferLength, int &width, int &height, int &frameCount);
+
+// The factor to reduce a decoded image by before reading it. stb_image cannot decode at a lower resolution,
+// so downscaleOnDecode always decodes the full image first and reduces it afterwards. The short side is kept at no less than one
+// downscale step above `downscaleThreshold`, so ZXing still builds its downscaled layers from the reduced
+// image, but never reads a layer of the full decoded resolution.
+int reductionScale(int width, int height, const ZXing::ReaderOptions &readerOptions);
+
+// Box-filters a luma image down by `scale` in place.
+void reduceLuma(uint8_t *pixels, int width, int height, int scale);
+
+// Reduces a decoded image right after loading it, see reductionScale, and gives the memory it no longer
+// needs back. Returns the scale the image was reduced by.
+int reduceImage(ImageBuffer &image, int &width, int &height, const ZXing::ReaderOptions &readerOptions);
+
+// Maps regions of the full image into an image reduced by `scale`, rounding outwards.
+Rects reduceRegions(const Rects &regions, int scale);
+
+// Maps the positions of barcodes read from an image reduced by `scale` back to the full image.
+ZXing::Barcodes enlargePositions(ZXing::Barcodes barcodes, int scale);
+
+// Reads an image that was reduced by `scale`, with regions and positions in the coordinates of the full image.
+ZXing::Barcodes readReducedImage(const ZXing::ImageView &imageView, int scale, const ReaderConfig &config);
+
+// Converts RGBA pixels to luma with the integer weights ZXing uses for its own conversion.
+void rgbaToLuma(const uint8_t *rgba, std::size_t pixelCount, uint8_t *luma);
+
+// The view to read an RGBA pixmap through. The SIMD build converts the pixmap to luma up front into `scratch`,
+// sparing ZXing its scalar per-pixel conversion. Other builds hand the RGBA pixels to ZXing as they are.
+ZXing::ImageView pixmapView(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &scratch);
+
+// Luma scratch for the pixmap reads of the free functions, the session has its own
+extern thread_local std::vector<uint8_t> pixmapLuma;
+
+// ------------------ Read entry points ------------------
+template <typename Results>
+void readFromImage(const uint8_t *bufferPtr, int bufferLength, const ReaderConfig &config, Results &results) {
+  beginRead(config);
+  try {
+    auto start = Clock::now();
+    int width, height;
+    auto buffer = loadImage(bufferPtr, bufferLength, width, height);
+    if (!buffer) {
+      appendError(results, "Failed to load image from memory", "", 0);
+      return;
+    }
+    int scale = config.downscaleOnDecode ? reduceImage(buffer, width, height, config.readerOptions) : 1;
+    readProfiler.add(&ReadProfile::decodeMs, elapsedMs(start));
+    appendAuthorizedRead(
+      config.accessToken,
+      [&] { return readReducedImage({buffer.get(), width, height, ZXing::ImageFormat::Lum}, scale, config); },
+      results
+    );
+  } catch (const std::exception &e) {
+    std::cerr << "AR:358:" << e.what() << '\n';
+    results.clear();
+    appendError(results, statusToMessage(403), statusToMessage(403), 403);
+  }
+}
+
+template <typename Results>
+void readFromPixmap(const uint8_t *bufferPtr, int width, int height, const ReaderConfig &config, Results &results) {
+  beginRead(config);
+  try {
+    auto start = Clock::now();
+    auto imageView = pixmapView(bufferPtr, width, height, pixmapLuma);
+    readProfiler.add(&ReadProfile::decodeMs, elapsedMs(start));
+    appendAuthorizedRead(config.accessToken, [&] { return readCascade(imageView, config, config.regions); }, results);
+  } catch (const std::exception &e) {
+    results.clear();
+    appendError(results, statusToMessage(403), statusToMessage(403), 403);
+  }
+}
+
+// Reads a single-channel luma plane, e.g. the Y plane of an NV12 / I420 frame.
+// `rowStride` is the distance in bytes between the starts of two consecutive rows.
+template <typename Results>
+void readFromLuma(const uint8_t *bufferPtr, int width, int height, int rowStride, const ReaderConfig &config, Results &results) {
+  beginRead(config);
+  try {
+    if (rowStride < width) {
+      appendError(results, "Row stride is smaller than the width", statusToMessage(400), 400);
+      return;
+    }
+    ZXing::ImageView imageView{bufferPtr, width, height, ZXing::ImageFormat::Lum, rowStride};
+    appendAuthorizedRead(config.accessToken, [&] { return readCascade(imageView, config, config.regions); }, results);
+  } catch (const std::exception &e) {
+    results.clear();
+    appendError(results, statusToMessage(403), statusToMessage(403), 403);
+  }
+}
+
+// ------------------ Batch reading ------------------
+// Bits of the per-image flags of a packed batch
+enum PackedImageFlag : int32_t {
+  PackedBudgetExceeded = 1 << 0,
+};
+
+// Reads many encoded images in one call. The access token is checked once for the whole batch, and stb_image
+// decodes every image into a DecodeArena borrowed from the arenas of the call. Builds with a thread pool read several
+// images at once. The results of all images are packed into one buffer, prefixed with an index of `3 * count + 1`
+// int32: the number of images, then for every image the number of records up to and including it, then for
+// every image its cascade tier, then for every image its PackedImageFlag bits.
+class BatchReader {
+public:
+  struct ImageResult {
+    ZXing::Barcodes barcodes;
+    std::string error;
+    std::string message;
+    int status = 200;
+    double readMs = 0;
+    int cascadeTier = -1;
+    bool budgetExceeded = false;
+  };
+
+  // `inputs` holds the encoded images back to back, `offsets` the count + 1 boundaries between them.
+  const std::vector<uint8_t> &read(const uint8_t *inputs, const int32_t *offsets, int count, const ReaderConfig &config, int fields);
+
+  // Reads a single encoded image of a batch, on the calling thread. Errors only end up in the result of
+  // this image, the rest of the batch is still read. The access token is not checked.
+  static ImageResult readImage(const uint8_t *bufferPtr, int bufferLength, const ReaderConfig &config);
+
+  // Reads every frame of one encoded image in turn, see loadFrames, packed like a batch with one entry per frame.
+  // All frames are decoded in one go into a single buffer. With `stopAtFirstCode`, reading ends at the first frame
+  // that yields a valid barcode and only the frames up to it are packed.
+  const std::vector<uint8_t> &readFrames(const uint8_t *bufferPtr, int bufferLength, const ReaderConfig &config, int fields, bool stopAtFirstCode);
+
+private:
+  // Decodes the image into `arena`, which is reset afterwards
+  static ImageResult readImage(const uint8_t *bufferPtr, int bufferLength, const ReaderConfig &config, DecodeArena &arena);
+
+  // Reads a decoded luma image that was reduced by `scale`, turning what the read throws into an error result
+  static ImageResult readLuma(const uint8_t *pixels, int width, int height, int scale, const ReaderConfig &config);
+
+  void begin(int fields);
+  void append(const ImageResult &image);
+  const std::vector<uint8_t> &pack();
+
+  std::vector<int32_t> index;
+  std::vector<int32_t> tiers;
+  std::vector<int32_t> flags; // PackedImageFlag bits of every image
+  PackedReadResults packedReadResults;
+};
+
+// ------------------ Tracking ------------------
+// Follows barcodes across the frames of a video. While the barcodes of the previous frame are known, only
+// windows around their positions are read. A full scan runs when one of them is missed in its window and
+// every `fullScanInterval` frames, so new barcodes are still picked up. A barcode with the same content as
+// one of the previous frame, close to its last position, keeps the ID of that track.
+class BarcodeTracker {
+public:
+  // 0 disables tracking, every frame is then fully scanned and no IDs are assigned
+  void setFullScanInterval(int interval) {
+    fullScanInterval = std::max(interval, 0);
+    tracks.clear();
+    trackIds.clear();
+  }
+
+  bool enabled() const {
+    return fullScanInterval > 0;
+  }
+
+  ZXing::Barcodes read(const ZXing::ImageView &imageView, const ReaderConfig &config, const Rects &regions);
+
+  // Track IDs of the barcodes of the last read, in the same order. Empty when tracking is off or the read failed.
+  const std::vector<int32_t> &ids() const {
+    return trackIds;
+  }
+
+  void clearIds() {
+    trackIds.clear();
+  }
+
+private:
+  struct Track {
+    ZXing::Barcode barcode;
+    int32_t id;
+  };
+
+  static Rect window(const ZXing::Position &position);
+  static bool isSameTrack(const ZXing::Barcode &previous, const ZXing::Barcode &barcode);
+  Rects windows() const;
+  void update(const ZXing::Barcodes &barcodes);
+
+  static constexpr int kMinWindowSize = 32;
+
+  int fullScanInterval = 0;
+  int framesSinceFullScan = 0;
+  int32_t nextId = 0;
+  std::vector<Track> tracks;
+  std::vector<int32_t> trackIds;
+};
+
+// ------------------ Change detection ------------------
+// Tells near-identical frames of a video apart from changed ones, so their read can be skipped. A frame is
+// reduced to a grid of block means of its luma, sampled at a few points per block. When the mean absolute
+// difference to the grid of the last scanned frame is below `threshold`, the frame counts as unchanged and
+// the results of that frame are reused. Comparing against the last scanned frame and not the previous one
+// keeps a slow drift from adding up unnoticed.
+class ChangeDetector {
+public:
+  struct Stats {
+    double frames = 0;
+    double skipped = 0;
+  };
+
+  // `threshold` is in luma levels (0-255), 0 disables change detection
+  void setThreshold(double value) {
+    threshold = std::max(value, 0.0);
+    counters = {};
+    reset();
+  }
+
+  bool enabled() const {
+    return threshold > 0;
+  }
+
+  // Forgets the last scanned frame, so the next frame is read whatever it looks like
+  void reset() {
+    hasReference = false;
+    barcodes.clear();
+    trackIds.clear();
+    tier = -1;
+  }
+
+  // Whether `imageView` is close enough to the last scanned frame to reuse its results
+  bool unchanged(const ZXing::ImageView &imageView);
+
+  // Makes the last changed frame the reference, once it was read successfully and in full
+  void remember(const ZXing::Barcodes &results, const std::vector<int32_t> &ids, int cascadeTier) {
+    hasReference = true;
+    reference = candidate;
+    width = candidateWidth;
+    height = candidateHeight;
+    barcodes = results;
+    trackIds = ids;
+    tier = cascadeTier;
+  }
+
+  const ZXing::Barcodes &results() const {
+    return barcodes;
+  }
+
+  const std::vector<int32_t> &ids() const {
+    return trackIds;
+  }
+
+  // The cascade tier that read the results
+  int resultsTier() const {
+    return tier;
+  }
+
+  const Stats &stats() const {
+    return counters;
+  }
+
+private:
+  static constexpr int kGridSize = 16;
+  static constexpr int kSamplesPerBlock = 4; // per axis
+
+  using Fingerprint = std::array<uint8_t, kGridSize * kGridSize>;
+  static Fingerprint fingerprint(const ZXing::ImageView &imageView);
+
+  double threshold = 0;
+  bool hasReference = false;
+  int width = 0;
+  int height = 0;
+  Fingerprint reference{};
+  int candidateWidth = 0;
+  int candidateHeight = 0;
+  Fingerprint candidate{};
+  ZXing::Barcodes barcodes;
+  std::vector<int32_t> trackIds;
+  int tier = -1;
+  Stats counters;
+};
+
+#endif
+
+#if defined(WRITER)
+  #include "WriteBarcode.h"
+  #include <list>
+  #include <string_view>
+  #include <unordered_map>
+
+// The options of a write, as passed in by the caller
+struct WriterConfig {
+  // ZXing::CreatorOptions
+  int format;
+  bool readerInit;
+  std::string ecLevel;
+  std::string options;
+  // ZXing::WriterOptions
+  int scale;
+  int sizeHint;
+  int rotate;
+  bool withHRT;
+  bool withQuietZones;
+  // Outputs to produce
+  int outputs; // WriteOutput bits
+  int pngCompressionLevel;
+  uint8_t pixmapFormat; // PixmapFormat
+};
+
+// Bits of WriterConfig::outputs
+enum WriteOutput : int {
+  WritePNG = 1 << 0,
+  WriteSVG = 1 << 1,
+  WriteUtf8 = 1 << 2,
+  WriteSymbol = 1 << 3,
+  WritePixmap = 1 << 4,
+};
+
+enum PixmapFormat : uint8_t {
+  PixmapLum = 0,
+  PixmapRGBA = 1,
+};
+
+ZXing::CreatorOptions createCreatorOptions(const WriterConfig &config);
+ZXing::WriterOptions createWriterOptions(const WriterConfig &config);
+
+// Encodes `image` as PNG and appends it to `data`.
+void appendPNG(const ZXing::Image &image, int compressionLevel, std::vector<uint8_t> &data);
+
+// Converts `image` into `channels` (1 or 4) bytes per pixel at `pixmap`, rows without padding.
+void copyPixmap(const ZXing::Image &image, int channels, uint8_t *pixmap);
+
+// ------------------ Batch writer ------------------
+// One entry of the offset table of a packed batch. Offsets are relative to the start of the data section,
+// outputs that were not requested (or failed) have a length of 0.
+struct PackedWriteEntry {
+  PackedSpan error;
+  PackedSpan png;
+  PackedSpan svg;
+  PackedSpan utf8;
+  PackedSpan symbol;
+  int32_t symbolWidth;
+  int32_t symbolHeight;
+  PackedSpan pixmap;
+  int32_t pixmapWidth;
+  int32_t pixmapHeight;
+};
+static_assert(sizeof(PackedWriteEntry) == 64, "the packed layout is mirrored in src/bindings/packedWriteResult.ts");
+
+// The outputs of one barcode, packed like a batch entry with the offsets relative to `data`
+struct WrittenBarcode {
+  PackedWriteEntry entry{};
+  std::vector<uint8_t> data;
+};
+
+// Encodes and renders the outputs selected in `config.outputs`. The bitmap is only rendered if a PNG or a
+// pixmap is requested.
+WrittenBarcode writeOutputs(const ZXing::Barcode &barcode, const ZXing::WriterOptions &writerOptions, const WriterConfig &config);
+
+// Creates the barcode of `payload` (text or bytes) and writes its outputs, see writeOutputs
+WrittenBarcode writePayload(
+  const char *payload,
+  int length,
+  bool isText,
+  const WriterConfig &config,
+  const ZXing::CreatorOptions &creatorOptions,
+  const ZXing::WriterOptions &writerOptions
+);
+
+// The least recently used outputs of single writes, keyed on the payload and the writer options, so
+// payloads written over and over (SKUs, store codes, fixed URLs) skip creating, rendering and PNG encoding.
+// Bounded by the bytes of the outputs and keys it holds. Like ReaderStats, only used from the thread that
+// called into the writer.
+class WriteCache {
+public:
+  static constexpr std::size_t kDefaultCapacity = 4 << 20;
+
+  struct Stats {
+    double hits = 0;
+    double misses = 0;
+    double entries = 0;
+    double bytes = 0;
+    double capacity = 0;
+  };
+
+  // The outputs of `payload` (text or bytes) with `config`, from the cache or created now and cached. Throws
+  // what creating the barcode throws, errors are not cached. Only valid until the next call.
+  const WrittenBarcode &write(
+    const char *payload,
+    int length,
+    bool isText,
+    const WriterConfig &config,
+    const ZXing::CreatorOptions &creatorOptions,
+    const ZXing::WriterOptions &writerOptions
+  );
+
+  // 0 turns the cache off. Evicts the least recently used entries that no longer fit.
+  void setCapacity(std::size_t capacity);
+
+  // Drops every entry and resets the counters
+  void purge();
+
+  Stats stats() const;
+
+private:
+  using Entry = std::pair<std::string, WrittenBarcode>;
+
+  static std::string key(const char *payload, int length, bool isText, const WriterConfig &config);
+  static std::size_t cost(const Entry &entry);
+  void evict(std::size_t needed);
+
+  std::list<Entry> entries; // most recently used first
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index; // views of the keys in `entries`
+  WrittenBarcode uncached; // result of the last write while the cache is off or the outputs do not fit
+  std::size_t bytes = 0;
+  std::size_t capacity = kDefaultCapacity;
+  double hits = 0;
+  double misses = 0;
+};
+
+extern WriteCache writeCache;
+
+// Writes many barcodes with one set of options. The creator and writer options are converted once and
+// all outputs are appended to one reused buffer: a header of two int32 (number of entries, entry size),
+// the offset table, then the data section. Batches bypass the WriteCache, a batch of mostly new payloads
+// would only evict the outputs single writes keep coming back for.
+class BatchWriter {
+public:
+  // `inputs` holds the payloads back to back, `offsets` the count + 1 boundaries between them, and `isText` one
+  // flag per payload telling UTF-8 text from binary data. Returns the packed buffer, only valid until the next batch.
+  const std::vector<uint8_t> &write(const uint8_t *inputs, const int32_t *offsets, const uint8_t *isText, int count, const WriterConfig &config);
+
+private:
+  static constexpr std::size_t kHeaderSize = 2 * sizeof(int32_t);
+
+  PackedSpan append(const void *bytes, std::size_t length);
+
+  std::vector<PackedWriteEntry> entries;
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> buffer;
+};
+
+#endif
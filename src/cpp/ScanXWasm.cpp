@@ -4,34 +4,18 @@
  * Copyright 2023 Ze-Zheng Wu
  */
 // SPDX-License-Identifier: Apache-2.0
+
+// The embind glue of the WASM modules: converts the JS options and results, the reading and writing
+// itself lives in ScanXCore.cpp.
+#include "ScanXCore.h"
 #include <emscripten/bind.h>
+#include <emscripten/emscripten.h>
 #include <emscripten/val.h>
-#include <memory>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string>
-
-// ------------------------------start my include import-------------------------------
-// this for isDateValid
-#include <ctime>
-// this 2 for decode accessToken
-#include <iomanip>
-#include <iostream>
-#include <sstream>
-// this for isValidDataFormat
-#include <regex>
-//------------------------------- env my include or import---------------------------------
-
-#if defined(READER)
-  #include "ReadBarcode.h"
-  #define STB_IMAGE_IMPLEMENTATION
-  #include <stb_image.h>
-#endif
-
-#if defined(WRITER)
-  #include "WriteBarcode.h"
-  #define STB_IMAGE_WRITE_IMPLEMENTATION
-  #include <stb_image_write.h>
-#endif
+#include <vector>
 
 using namespace emscripten;
 
@@ -55,8 +39,32 @@ Symbol createSymbolFromBarcodeSymbol(const ZXing::ImageView &barcodeSymbol) {
   };
 }
 
+// A view into the module heap over a buffer of the core, only valid until the buffer is written again
+val view(const std::vector<uint8_t> &buffer) {
+  return val(typed_memory_view(buffer.size(), buffer.data()));
+}
+
 #if defined(READER)
 
+#if defined(SCANX_THREADS)
+// Only the browser main thread has a document, workers and Node.js may wait for the pool
+EM_JS(int, isBrowserMainThread, (), { return typeof document != 'undefined'; });
+#endif
+
+// The reader options a cascade tier overrides, the others are taken from the JsReaderOptions
+struct JsCascadeTier {
+  bool tryHarder;
+  bool tryRotate;
+  bool tryInvert;
+  bool tryDownscale;
+  bool tryDenoise;
+  uint8_t binarizer;
+  bool isPure;
+  uint16_t downscaleThreshold;
+  uint8_t downscaleFactor;
+  uint8_t minLineCount;
+};
+
 struct JsReaderOptions {
   int formats;
   bool tryHarder;
@@ -68,6 +76,10 @@ struct JsReaderOptions {
   bool isPure;
   uint16_t downscaleThreshold;
   uint8_t downscaleFactor;
+  bool downscaleOnDecode;
+  uint32_t tileMemoryLimit;
+  uint16_t tileOverlap;
+  double timeBudgetMs;
   uint8_t minLineCount;
   uint8_t maxNumberOfSymbols;
   bool tryCode39ExtendedMode;
@@ -75,7 +87,10 @@ struct JsReaderOptions {
   uint8_t eanAddOnSymbol;
   uint8_t textMode;
   uint8_t characterSet;
+  bool profile; // record the stage timings of every read, see ReadProfiler
   std::string accessToken; // add `accessToken`
+  val regions; // Rect[], empty to read the whole image
+  val cascade; // CascadeTier[], empty to read once with the options above
 };
 
 struct JsReadResult {
@@ -105,379 +120,483 @@ struct JsReadResult {
   int status;
 };
 
-// ------------------------------------------start my types------------------
-// Define the struct to hold the response
-struct AuthResponse {
-  int status; // Status code
-};
-struct DecryptedResponse {
-  int status; // Status code
-  std::string decrypted;
-};
+using JsReadResults = std::vector<JsReadResult>;
+
+namespace {
 
-// ------------------------------------------end my types------------------
-// ------------------------------------------------start my custom functions----------------------------------------------------------------
-// Status Codes for isValidDateFormat
-// Code	Description
-// 103	Date format is not supported.
-// Status Codes for isDateValidToday
-// Code	Description
-// 200	Date matches today's date.
-// Status Code for Timeout
-// Code	Description
-// 408	Request or operation timed out.
-// 400	Invalid key provided.
-
-std::string statusToMessage(const int &status) {
-  switch (status) {
-    case 103:
-      return "Date format is not supported.";
-    case 200:
-      return "Date matches today's date.";
-    case 408:
-      return "Request or operation timed out.";
-    case 400:
-      return "Invalid key provided.";
-    case 403:
-      return "Forbidden.";
-    default:
-      return "Unknown Error.";
+  ZXing::ReaderOptions createReaderOptions(const JsReaderOptions &jsReaderOptions) {
+    return ZXing::ReaderOptions()
+      .setFormats(static_cast<ZXing::BarcodeFormat>(jsReaderOptions.formats))
+      .setTryHarder(jsReaderOptions.tryHarder)
+      .setTryRotate(jsReaderOptions.tryRotate)
+      .setTryInvert(jsReaderOptions.tryInvert)
+      .setTryDownscale(jsReaderOptions.tryDownscale)
+      .setTryDenoise(jsReaderOptions.tryDenoise)
+      .setBinarizer(static_cast<ZXing::Binarizer>(jsReaderOptions.binarizer))
+      .setIsPure(jsReaderOptions.isPure)
+      .setDownscaleThreshold(jsReaderOptions.downscaleThreshold)
+      .setDownscaleFactor(jsReaderOptions.downscaleFactor)
+      .setMinLineCount(jsReaderOptions.minLineCount)
+      .setMaxNumberOfSymbols(jsReaderOptions.maxNumberOfSymbols)
+      .setTryCode39ExtendedMode(jsReaderOptions.tryCode39ExtendedMode)
+      .setReturnErrors(jsReaderOptions.returnErrors)
+      .setEanAddOnSymbol(static_cast<ZXing::EanAddOnSymbol>(jsReaderOptions.eanAddOnSymbol))
+      .setTextMode(static_cast<ZXing::TextMode>(jsReaderOptions.textMode))
+      .setCharacterSet(static_cast<ZXing::CharacterSet>(jsReaderOptions.characterSet));
   }
-}
 
-AuthResponse isDateValidToday(const std::string &inputDate) {
-  // Get today's date
-  time_t t = time(0);
-  tm *currentDate = localtime(&t);
+  Rects createRegions(const JsReaderOptions &jsReaderOptions) {
+    if (jsReaderOptions.regions.isUndefined() || jsReaderOptions.regions.isNull()) return {};
+    return vecFromJSArray<Rect>(jsReaderOptions.regions);
+  }
 
-  // Convert inputDate to tm structure
-  int day, month, year;
-  sscanf(inputDate.c_str(), ":__%d-%d-%d__:", &day, &month, &year);
-  // Extract day, month, and year
-  int c_day = currentDate->tm_mday; // Day of the month (1-31)
-  int c_month = currentDate->tm_mon + 1; // Month (0-11, so add 1 to get 1-12)
-  int c_year = currentDate->tm_year + 1900; // Year since 1900, so add 1900
+  std::vector<ZXing::ReaderOptions> createCascade(const JsReaderOptions &jsReaderOptions, const ZXing::ReaderOptions &readerOptions) {
+    if (jsReaderOptions.cascade.isUndefined() || jsReaderOptions.cascade.isNull()) return {};
+    std::vector<ZXing::ReaderOptions> cascade;
+    for (const auto &tier : vecFromJSArray<JsCascadeTier>(jsReaderOptions.cascade)) {
+      auto &tierOptions = cascade.emplace_back(readerOptions);
+      tierOptions.setTryHarder(tier.tryHarder)
+        .setTryRotate(tier.tryRotate)
+        .setTryInvert(tier.tryInvert)
+        .setTryDownscale(tier.tryDownscale)
+        .setTryDenoise(tier.tryDenoise)
+        .setBinarizer(static_cast<ZXing::Binarizer>(tier.binarizer))
+        .setIsPure(tier.isPure)
+        .setDownscaleThreshold(tier.downscaleThreshold)
+        .setDownscaleFactor(tier.downscaleFactor)
+        .setMinLineCount(tier.minLineCount);
+    }
+    return cascade;
+  }
 
-  AuthResponse response;
-  if (day == c_day && month == c_month && year == c_year) {
-    response.status = 200;
+  ReaderConfig createReaderConfig(const JsReaderOptions &jsReaderOptions) {
+    auto readerOptions = createReaderOptions(jsReaderOptions);
+    auto cascade = createCascade(jsReaderOptions, readerOptions);
+    return {
+      .readerOptions = std::move(readerOptions),
+      .regions = createRegions(jsReaderOptions),
+      .cascade = std::move(cascade),
+      .downscaleOnDecode = jsReaderOptions.downscaleOnDecode,
+      .tileMemoryLimit = jsReaderOptions.tileMemoryLimit,
+      .tileOverlap = jsReaderOptions.tileOverlap,
+      .timeBudgetMs = jsReaderOptions.timeBudgetMs,
+      .profile = jsReaderOptions.profile,
+      .accessToken = jsReaderOptions.accessToken,
+    };
+  }
 
-    return response;
-  } else {
-    // std::cout << "day: " << c_day << std::endl;
-    // std::cout << "month: " << c_month << std::endl;
-    // std::cout << "year: " << c_year << std::endl;
-    // std::cout << "not pass date" << std::endl;
-    std::cout << "scanx-core-151" << std::endl;
+  JsReadResult createJsReadResult(const ZXing::Barcode &barcode) {
+    auto barcodeSymbol = barcode.symbol();
+    return {
+      .isValid = barcode.isValid(),
+      .error = ZXing::ToString(barcode.error()),
+      .format = static_cast<int>(barcode.format()),
+      .bytes = std::move(Uint8Array.new_(val(typed_memory_view(barcode.bytes().size(), barcode.bytes().data())))),
+      .bytesECI = std::move(Uint8Array.new_(val(typed_memory_view(barcode.bytesECI().size(), barcode.bytesECI().data())))),
+      .text = barcode.text(),
+      .ecLevel = barcode.ecLevel(),
+      .contentType = static_cast<int>(barcode.contentType()),
+      .hasECI = barcode.hasECI(),
+      .position = barcode.position(),
+      .orientation = barcode.orientation(),
+      .isMirrored = barcode.isMirrored(),
+      .isInverted = barcode.isInverted(),
+      .symbologyIdentifier = barcode.symbologyIdentifier(),
+      .sequenceSize = barcode.sequenceSize(),
+      .sequenceIndex = barcode.sequenceIndex(),
+      .sequenceId = barcode.sequenceId(),
+      .readerInit = barcode.readerInit(),
+      .lineCount = barcode.lineCount(),
+      .version = barcode.version(),
+      .symbol = createSymbolFromBarcodeSymbol(barcodeSymbol),
+      .extra = barcode.extra(),
+      .message = "success",
+      .status = 200
+    };
+  }
 
-    response.status = 408;
+} // anonymous namespace
 
-    return response;
-  }
+// The value_object counterparts of the PackedReadResults overloads in ScanXCore.h, found by the read
+// templates there through argument dependent lookup, so they must not live in the anonymous namespace.
+void appendResults(JsReadResults &jsReadResults, const ZXing::Barcodes &barcodes) {
+  jsReadResults.reserve(jsReadResults.size() + barcodes.size());
+  for (const auto &barcode : barcodes)
+    jsReadResults.push_back(createJsReadResult(barcode));
 }
 
-// Function to calculate the checksum of the key (in hex format)
-std::string calculateHexSumOfKey(const std::string &key) {
-  int sum = 0;
-  for (char c : key) {
-    sum += static_cast<int>(c);
-  }
-  std::ostringstream hexSum;
-  hexSum << std::hex << std::setw(4) << std::setfill('0') << sum;
-  return hexSum.str();
+void appendError(JsReadResults &jsReadResults, const std::string &error, const std::string &message, int status) {
+  jsReadResults.push_back({.error = error, .message = message, .status = status});
 }
-// Decrypt a message
-// Function to decrypt the input using the correct key
-DecryptedResponse customDecrypt(const std::string &encrypted, const std::string &key) {
-  try {
-    std::string decrypted;
-    std::string hexSumOfKey = calculateHexSumOfKey(key);
 
-    // Loop through the encrypted string, processing each character segment
-    for (size_t i = 0; i < encrypted.length(); i += 8) {
-      if (encrypted.length() < i + 8) {
-        throw std::runtime_error("Encrypted string too short");
-      }
+// ------------------ Profiling ------------------
+ReadProfile getReadProfile() {
+  return readProfiler.last();
+}
 
-      std::string xorHex = encrypted.substr(i, 2);
-      std::string keyHex = encrypted.substr(i + 2, 2);
-      std::string checksum = encrypted.substr(i + 4, 4);
+val getReaderStats() {
+  val jsFormats = val::array();
+  for (const auto &[format, stats] : readerStats.formats) {
+    val jsFormat = val::object();
+    jsFormat.set("format", format);
+    jsFormat.set("count", stats.count);
+    jsFormat.set("readMs", stats.readMs);
+    jsFormats.call<void>("push", jsFormat);
+  }
+  val jsStats = val::object();
+  jsStats.set("calls", readerStats.calls);
+  jsStats.set("formats", jsFormats);
+  jsStats.set("heapHighWater", readerStats.heapHighWater);
+  jsStats.set("allocations", static_cast<double>(allocationCount.load()));
+  return jsStats;
+}
 
-      // Validate that the checksum matches
-      if (checksum != hexSumOfKey) {
-        throw std::runtime_error("Invalid key or corrupted data");
-      }
+void resetReaderStats() {
+  readerStats.reset();
+}
 
-      // Convert the hex to an integer and perform the XOR operation
-      int xorCharCode = std::stoi(xorHex, nullptr, 16);
-      int keyCharCode = std::stoi(keyHex, nullptr, 16);
-      char charCode = xorCharCode ^ keyCharCode;
+int getCascadeTier() {
+  return cascadeTier;
+}
 
-      decrypted += charCode;
-    }
-    DecryptedResponse response;
-    response.status = 200;
-    response.decrypted = decrypted;
-    return response;
-  } catch (const std::exception &e) {
-    std::cerr << e.what() << '\n';
-    DecryptedResponse response;
-    response.status = 401;
-    response.decrypted = "";
-    return response;
-  }
+bool getBudgetExceeded() {
+  return readBudget.exceeded;
 }
 
-bool isValidDateFormat(const std::string &date) {
-  try {
-    // Regular expression for the format __DD-MM-YYYY__
-    std::regex datePattern("^:__([0-2][0-9]|3[0-1])-(0[1-9]|1[0-2])-(\\d{4})__:$");
-
-    // Check if the date matches the pattern
-    return std::regex_match(date, datePattern);
-  } catch (const std::regex_error &e) {
-    // Handle regular expression errors
-    std::cerr << "Regex error: " << e.what() << std::endl;
-    return false; // Return false if regex fails
-  }
+// ------------------ Read entry points ------------------
+JsReadResults readBarcodesFromImage(int bufferPtr, int bufferLength, const JsReaderOptions &jsReaderOptions) {
+  JsReadResults jsReadResults;
+  readFromImage(reinterpret_cast<const uint8_t *>(bufferPtr), bufferLength, createReaderConfig(jsReaderOptions), jsReadResults);
+  return jsReadResults;
 }
-AuthResponse isAccessTokenIsValidToday(const std::string &accessToken) {
-  try {
-    if (accessToken.empty()) {
-      throw std::invalid_argument("Access token -> is empty");
-    }
-    std::string key = accessToken.substr(0, 36); // First 2 letters
-    std::string encrypted = accessToken.substr(36); // Rest of the string after skipping first 2 letters
 
-    if (encrypted.empty()) {
-      throw std::invalid_argument("Access token -> encrypted is empty");
-    }
-    if (key.empty()) {
-      throw std::invalid_argument("Access token -> key is empty");
-    }
-    // Decrypt with the correct key
-    if (encrypted.length() < 8) {
-      throw std::runtime_error("Encrypted string too short");
-    }
-    DecryptedResponse decryptedRes = customDecrypt(encrypted, key);
-    if (decryptedRes.status != 200) {
-      AuthResponse response;
-      response.status = decryptedRes.status;
-      return response;
-    }
-    std::string decrypted = decryptedRes.decrypted;
-    if (isValidDateFormat(decrypted)) {
-      return isDateValidToday(decrypted);
-    } else {
-      AuthResponse response;
-      response.status = 103;
-      return response;
-    }
-  } catch (const std::runtime_error &e) {
-    std::cout << "Runtime Error: " << e.what() << std::endl;
-    AuthResponse response;
-    response.status = 400;
-    return response;
-  } catch (const std::logic_error &e) {
-    std::cout << "Logic Error: " << e.what() << std::endl;
-    AuthResponse response;
-    response.status = 400;
-    return response;
-  } catch (const std::exception &e) {
-    std::cout << "Standard Exception: " << e.what() << std::endl;
-    AuthResponse response;
-    response.status = 400;
-    return response;
-  } catch (...) {
-    std::cout << "Unknown Exception Caught" << std::endl;
-    AuthResponse response;
-    response.status = 400;
-    return response;
-  }
+JsReadResults readBarcodesFromPixmap(int bufferPtr, int width, int height, const JsReaderOptions &jsReaderOptions) {
+  JsReadResults jsReadResults;
+  readFromPixmap(reinterpret_cast<const uint8_t *>(bufferPtr), width, height, createReaderConfig(jsReaderOptions), jsReadResults);
+  return jsReadResults;
 }
-//---------------------------------------------------------- env my custom functions-----------------------------------------------
 
-using JsReadResults = std::vector<JsReadResult>;
+JsReadResults readBarcodesFromLuma(int bufferPtr, int width, int height, int rowStride, const JsReaderOptions &jsReaderOptions) {
+  JsReadResults jsReadResults;
+  readFromLuma(reinterpret_cast<const uint8_t *>(bufferPtr), width, height, rowStride, createReaderConfig(jsReaderOptions), jsReadResults);
+  return jsReadResults;
+}
 
-JsReadResults readBarcodes(ZXing::ImageView imageView, const JsReaderOptions &jsReaderOptions) {
-  try {
-    auto barcodes = ZXing::ReadBarcodes(
-      imageView,
-      ZXing::ReaderOptions()
-        .setFormats(static_cast<ZXing::BarcodeFormat>(jsReaderOptions.formats))
-        .setTryHarder(jsReaderOptions.tryHarder)
-        .setTryRotate(jsReaderOptions.tryRotate)
-        .setTryInvert(jsReaderOptions.tryInvert)
-        .setTryDownscale(jsReaderOptions.tryDownscale)
-        .setTryDenoise(jsReaderOptions.tryDenoise)
-        .setBinarizer(static_cast<ZXing::Binarizer>(jsReaderOptions.binarizer))
-        .setIsPure(jsReaderOptions.isPure)
-        .setDownscaleThreshold(jsReaderOptions.downscaleThreshold)
-        .setDownscaleFactor(jsReaderOptions.downscaleFactor)
-        .setMinLineCount(jsReaderOptions.minLineCount)
-        .setMaxNumberOfSymbols(jsReaderOptions.maxNumberOfSymbols)
-        .setTryCode39ExtendedMode(jsReaderOptions.tryCode39ExtendedMode)
-        .setReturnErrors(jsReaderOptions.returnErrors)
-        .setEanAddOnSymbol(static_cast<ZXing::EanAddOnSymbol>(jsReaderOptions.eanAddOnSymbol))
-        .setTextMode(static_cast<ZXing::TextMode>(jsReaderOptions.textMode))
-        .setCharacterSet(static_cast<ZXing::CharacterSet>(jsReaderOptions.characterSet))
-    );
+// ------------------ Packed results ------------------
+// Same as the functions above, but the results are returned as a view over one packed buffer,
+// see PackedReadResults. `fields` is a mask of PackedField bits selecting the optional fields.
+thread_local PackedReadResults packedReadResults;
 
-    JsReadResults jsReadResults;
-    jsReadResults.reserve(barcodes.size());
-
-    for (auto &barcode : barcodes) {
-
-      auto barcodeSymbol = barcode.symbol();
-
-      jsReadResults.push_back(
-        {.isValid = barcode.isValid(),
-         .error = ZXing::ToString(barcode.error()),
-         .format = static_cast<int>(barcode.format()),
-         .bytes = std::move(Uint8Array.new_(val(typed_memory_view(barcode.bytes().size(), barcode.bytes().data())))),
-         .bytesECI = std::move(Uint8Array.new_(val(typed_memory_view(barcode.bytesECI().size(), barcode.bytesECI().data())))),
-         .text = barcode.text(),
-         .ecLevel = barcode.ecLevel(),
-         .contentType = static_cast<int>(barcode.contentType()),
-         .hasECI = barcode.hasECI(),
-         .position = barcode.position(),
-         .orientation = barcode.orientation(),
-         .isMirrored = barcode.isMirrored(),
-         .isInverted = barcode.isInverted(),
-         .symbologyIdentifier = barcode.symbologyIdentifier(),
-         .sequenceSize = barcode.sequenceSize(),
-         .sequenceIndex = barcode.sequenceIndex(),
-         .sequenceId = barcode.sequenceId(),
-         .readerInit = barcode.readerInit(),
-         .lineCount = barcode.lineCount(),
-         .version = barcode.version(),
-         .symbol = createSymbolFromBarcodeSymbol(barcodeSymbol),
-         .extra = barcode.extra(),
-         .message = "success",
-         .status = 200}
-      );
-    }
-    return jsReadResults;
-  } catch (const std::exception &e) {
-    return {{.error = e.what(), .message = "try again", .status = 403}};
-  } catch (...) {
-    return {{.error = "Unknown error", .message = "try again", .status = 403}};
-  }
+val readBarcodesFromImagePacked(int bufferPtr, int bufferLength, const JsReaderOptions &jsReaderOptions, int fields) {
+  packedReadResults.clear();
+  packedReadResults.setFields(fields);
+  readFromImage(reinterpret_cast<const uint8_t *>(bufferPtr), bufferLength, createReaderConfig(jsReaderOptions), packedReadResults);
+  return view(packedReadResults.pack());
 }
 
-JsReadResults readBarcodesFromImage(int bufferPtr, int bufferLength, const JsReaderOptions &jsReaderOptions) {
-  try {
-    int width, height, channels;
-    std::unique_ptr<stbi_uc, void (*)(void *)> buffer(
-      stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(bufferPtr), bufferLength, &width, &height, &channels, 1), stbi_image_free
-    );
-    if (!buffer) {
-      return {{.error = "Failed to load image from memory"}};
-    }
-    // Check accessToken validity
-    AuthResponse dateRes = isAccessTokenIsValidToday(jsReaderOptions.accessToken);
-    if (dateRes.status == 200) {
-      return readBarcodes({buffer.get(), width, height, ZXing::ImageFormat::Lum}, jsReaderOptions);
-    } else {
-      return {{.error = statusToMessage(dateRes.status), .message = statusToMessage(dateRes.status), .status = dateRes.status}};
-    }
-  } catch (const std::exception &e) {
-    std::cerr << "AR:358:" << e.what() << '\n';
-    return {{.error = statusToMessage(403), .message = statusToMessage(403), .status = 403}};
-  }
+val readBarcodesFromPixmapPacked(int bufferPtr, int width, int height, const JsReaderOptions &jsReaderOptions, int fields) {
+  packedReadResults.clear();
+  packedReadResults.setFields(fields);
+  readFromPixmap(reinterpret_cast<const uint8_t *>(bufferPtr), width, height, createReaderConfig(jsReaderOptions), packedReadResults);
+  return view(packedReadResults.pack());
 }
 
-JsReadResults readBarcodesFromPixmap(int bufferPtr, int width, int height, const JsReaderOptions &jsReaderOptions) {
-  try {
-    AuthResponse dateRes = isAccessTokenIsValidToday(jsReaderOptions.accessToken);
-    if (dateRes.status == 200) {
-      return readBarcodes({reinterpret_cast<const uint8_t *>(bufferPtr), width, height, ZXing::ImageFormat::RGBA}, jsReaderOptions);
-    } else {
-      return {{.error = statusToMessage(dateRes.status), .message = statusToMessage(dateRes.status), .status = dateRes.status}};
-    }
-  } catch (const std::exception &e) {
-    return {{.error = statusToMessage(403), .message = statusToMessage(403), .status = 403}};
-  }
+val readBarcodesFromLumaPacked(int bufferPtr, int width, int height, int rowStride, const JsReaderOptions &jsReaderOptions, int fields) {
+  packedReadResults.clear();
+  packedReadResults.setFields(fields);
+  readFromLuma(reinterpret_cast<const uint8_t *>(bufferPtr), width, height, rowStride, createReaderConfig(jsReaderOptions), packedReadResults);
+  return view(packedReadResults.pack());
+}
+
+// ------------------ Batch reading ------------------
+thread_local BatchReader batchReader;
+
+val readBarcodesFromImages(int bufferPtr, int offsetsPtr, int count, const JsReaderOptions &jsReaderOptions, int fields) {
+  return view(batchReader.read(
+    reinterpret_cast<const uint8_t *>(bufferPtr), reinterpret_cast<const int32_t *>(offsetsPtr), count, createReaderConfig(jsReaderOptions), fields
+  ));
+}
+
+// Every frame of an animated GIF (any other image is a single frame), packed like a batch with one entry per frame
+val readBarcodesFromFrames(int bufferPtr, int bufferLength, const JsReaderOptions &jsReaderOptions, int fields, bool stopAtFirstCode) {
+  return view(
+    batchReader.readFrames(reinterpret_cast<const uint8_t *>(bufferPtr), bufferLength, createReaderConfig(jsReaderOptions), fields, stopAtFirstCode)
+  );
 }
 
 // ------------------ New single barcode function ------------------
 JsReadResult readSingleBarcodeFromPixmap(int dataPtr, int width, int height, const JsReaderOptions &options) {
-  auto results = readBarcodes({reinterpret_cast<const uint8_t *>(dataPtr), width, height, ZXing::ImageFormat::RGBA}, options);
+  auto config = createReaderConfig(options);
+  beginRead(config);
+  auto imageView = pixmapView(reinterpret_cast<const uint8_t *>(dataPtr), width, height, pixmapLuma);
+  JsReadResults results;
+  appendRead([&] { return readCascade(imageView, config, config.regions); }, results);
   if (!results.empty()) {
     return results.front();
   }
   return {.error = "No barcode found", .message = "No barcode found", .status = 404};
 }
 
+// ------------------ Persistent reader session ------------------
+// Keeps the input buffer, the converted reader options and the result storage alive
+// between calls, so scanning a stream of camera frames does not churn the allocator.
+class ReaderSession {
+public:
+  explicit ReaderSession(const JsReaderOptions &jsReaderOptions) {
+    setOptions(jsReaderOptions);
+  }
+
+  void setOptions(const JsReaderOptions &jsReaderOptions) {
+    config = createReaderConfig(jsReaderOptions);
+    changes.reset();
+  }
+
+  // Returns the address of an input buffer holding at least `size` bytes.
+  // The buffer only ever grows, so same-sized frames reuse the same memory.
+  int inputBuffer(int size) {
+    if (size > static_cast<int>(buffer.size())) buffer.resize(size);
+    return static_cast<int>(reinterpret_cast<std::uintptr_t>(buffer.data()));
+  }
+
+  const JsReadResults &readBarcodesFromImage(int bufferLength) {
+    jsReadResults.clear();
+    readImage(bufferLength, jsReadResults);
+    return jsReadResults;
+  }
+
+  const JsReadResults &readBarcodesFromPixmap(int width, int height) {
+    jsReadResults.clear();
+    readPixmap(width, height, jsReadResults);
+    return jsReadResults;
+  }
+
+  const JsReadResults &readBarcodesFromLuma(int width, int height, int rowStride) {
+    jsReadResults.clear();
+    readLuma(width, height, rowStride, jsReadResults);
+    return jsReadResults;
+  }
+
+  val readBarcodesFromImagePacked(int bufferLength, int fields) {
+    packedReadResults.clear();
+    packedReadResults.setFields(fields);
+    readImage(bufferLength, packedReadResults);
+    return view(packedReadResults.pack());
+  }
+
+  val readBarcodesFromPixmapPacked(int width, int height, int fields) {
+    packedReadResults.clear();
+    packedReadResults.setFields(fields);
+    readPixmap(width, height, packedReadResults);
+    return view(packedReadResults.pack());
+  }
+
+  val readBarcodesFromLumaPacked(int width, int height, int rowStride, int fields) {
+    packedReadResults.clear();
+    packedReadResults.setFields(fields);
+    readLuma(width, height, rowStride, packedReadResults);
+    return view(packedReadResults.pack());
+  }
+
+  // Reads only around the barcodes of the previous frame, see BarcodeTracker. 0 turns tracking off.
+  void setTracking(int fullScanInterval) {
+    tracker.setFullScanInterval(fullScanInterval);
+    changes.reset();
+  }
+
+  // A view of the track IDs of the last read, one per result, only valid until the next read
+  val trackIds() {
+    const auto &ids = skipped ? changes.ids() : tracker.ids();
+    return val(typed_memory_view(ids.size(), ids.data()));
+  }
+
+  // Reuses the results of the last scanned frame for frames that barely differ from it, see ChangeDetector.
+  // 0 turns change detection off.
+  void setChangeDetection(double threshold) {
+    changes.setThreshold(threshold);
+  }
+
+  // Whether the last read reused the results of an earlier frame
+  bool frameUnchanged() const {
+    return skipped;
+  }
+
+  val changeDetectionStats() const {
+    const auto &stats = changes.stats();
+    val jsStats = val::object();
+    jsStats.set("frames", stats.frames);
+    jsStats.set("skipped", stats.skipped);
+    return jsStats;
+  }
+
+private:
+  // `scale` is the factor an encoded image was reduced by after decoding, the tracker works in reduced coordinates
+  template <typename Results>
+  void read(const ZXing::ImageView &imageView, Results &results, int scale = 1) {
+    appendAuthorizedRead(
+      config.accessToken,
+      [&] {
+        // A skipped frame reports the tier of the results it reuses, and stays out of the reader stats
+        skipped = changes.enabled() && changes.unchanged(imageView);
+        if (skipped) {
+          cascadeTier = changes.resultsTier();
+          return changes.results();
+        }
+        auto barcodes = enlargePositions(tracker.read(imageView, config, reduceRegions(config.regions, scale)), scale);
+        // A read cut short by the time budget would be replayed for as long as the scene stays still
+        if (changes.enabled() && !readBudget.exceeded) changes.remember(barcodes, tracker.ids(), cascadeTier);
+        return barcodes;
+      },
+      results,
+      skipped
+    );
+  }
+
+  // Starts a read and runs `read`, what it throws (e.g. an image view ZXing rejects) is turned into an error
+  // result like in readFromPixmap
+  template <typename Results, typename Read>
+  void guardedRead(Results &results, Read read) {
+    tracker.clearIds();
+    skipped = false;
+    beginRead(config);
+    try {
+      read();
+    } catch (const std::exception &e) {
+      tracker.clearIds();
+      skipped = false;
+      results.clear();
+      appendError(results, statusToMessage(403), statusToMessage(403), 403);
+    }
+  }
+
+  template <typename Results>
+  void readImage(int bufferLength, Results &results) {
+    guardedRead(results, [&] {
+      auto start = Clock::now();
+      int width, height;
+      auto image = loadImage(buffer.data(), std::min(bufferLength, static_cast<int>(buffer.size())), width, height);
+      if (!image) {
+        appendError(results, "Failed to load image from memory", "", 0);
+        return;
+      }
+      int scale = config.downscaleOnDecode ? reduceImage(image, width, height, config.readerOptions) : 1;
+      readProfiler.add(&ReadProfile::decodeMs, elapsedMs(start));
+      read({image.get(), width, height, ZXing::ImageFormat::Lum}, results, scale);
+    });
+  }
+
+  template <typename Results>
+  void readPixmap(int width, int height, Results &results) {
+    guardedRead(results, [&] {
+      if (width <= 0 || height <= 0 || static_cast<std::size_t>(width) * height * 4 > buffer.size()) {
+        appendError(results, "Input buffer is smaller than the pixmap", statusToMessage(400), 400);
+        return;
+      }
+      auto start = Clock::now();
+      auto imageView = pixmapView(buffer.data(), width, height, luma);
+      readProfiler.add(&ReadProfile::decodeMs, elapsedMs(start));
+      read(imageView, results);
+    });
+  }
+
+  template <typename Results>
+  void readLuma(int width, int height, int rowStride, Results &results) {
+    guardedRead(results, [&] {
+      if (width <= 0 || height <= 0 || rowStride < width || static_cast<std::size_t>(rowStride) * (height - 1) + width > buffer.size()) {
+        appendError(results, "Input buffer is smaller than the luma plane", statusToMessage(400), 400);
+        return;
+      }
+      read({buffer.data(), width, height, ZXing::ImageFormat::Lum, rowStride}, results);
+    });
+  }
+
+  std::vector<uint8_t> buffer;
+  std::vector<uint8_t> luma;
+  ReaderConfig config;
+  BarcodeTracker tracker;
+  ChangeDetector changes;
+  bool skipped = false;
+  JsReadResults jsReadResults;
+  PackedReadResults packedReadResults;
+};
+
 #endif
 
 #if defined(WRITER)
 
-struct JsWriterOptions {
-  // ZXing::CreatorOptions
-  int format;
-  bool readerInit;
-  std::string ecLevel;
-  std::string options;
-  // ZXing::WriterOptions
-  int scale;
-  int sizeHint;
-  int rotate;
-  bool withHRT;
-  bool withQuietZones;
+struct JsWriterOptions : WriterConfig {
+  int pixmapPtr; // optional heap buffer receiving the pixmap, 0 to use the module's own buffer
+  int pixmapCapacity;
 };
 
 namespace {
 
-  ZXing::CreatorOptions createCreatorOptions(const JsWriterOptions &jsWriterOptions) {
-    return ZXing::CreatorOptions(static_cast<ZXing::BarcodeFormat>(jsWriterOptions.format))
-      .readerInit(jsWriterOptions.readerInit)
-      .ecLevel(jsWriterOptions.ecLevel)
-      .options(jsWriterOptions.options);
-  }
-
-  ZXing::WriterOptions createWriterOptions(const JsWriterOptions &jsWriterOptions) {
-    return ZXing::WriterOptions()
-      .scale(jsWriterOptions.scale)
-      .sizeHint(jsWriterOptions.sizeHint)
-      .rotate(jsWriterOptions.rotate)
-      .withHRT(jsWriterOptions.withHRT)
-      .withQuietZones(jsWriterOptions.withQuietZones);
-  }
+  // Receives pixmaps when the caller did not provide a buffer, grows to the largest pixmap written so far
+  std::vector<uint8_t> pixmapBuffer;
 
 } // anonymous namespace
 
+struct JsPixmap {
+  val data;
+  int width;
+  int height;
+};
+
 struct JsWriteResult {
   std::string error;
   std::string svg;
   std::string utf8;
   val image;
   Symbol symbol;
+  JsPixmap pixmap;
 };
 
-JsWriteResult writeBarcodeFromText(std::string text, const JsWriterOptions &jsWriterOptions) {
-  try {
-    auto barcode = ZXing::CreateBarcodeFromText(text, createCreatorOptions(jsWriterOptions));
-    auto writerOptions = createWriterOptions(jsWriterOptions);
-
-    auto image = ZXing::WriteBarcodeToImage(barcode, writerOptions);
+// Copies a written pixmap into the caller's pixmap buffer (or the module's own one) and returns a view of it.
+// The view is only valid until the next write or heap growth.
+JsPixmap writePixmap(const WrittenBarcode &written, const JsWriterOptions &jsWriterOptions) {
+  const std::size_t size = written.entry.pixmap.length;
 
-    int len;
-    uint8_t *bytes = stbi_write_png_to_mem(image.data(), image.rowStride(), image.width(), image.height(), ZXing::PixStride(image.format()), &len);
-
-    // Wrap into JS typed array *before* freeing.
-    val jsImage = Uint8Array.new_(val(typed_memory_view(len, bytes)));
-
-    free(bytes); // Prevent leak – STBI allocates with malloc
+  uint8_t *pixmap;
+  if (jsWriterOptions.pixmapPtr) {
+    if (static_cast<std::size_t>(jsWriterOptions.pixmapCapacity) < size) {
+      throw std::invalid_argument("Pixmap buffer is smaller than the " + std::to_string(size) + " bytes required");
+    }
+    pixmap = reinterpret_cast<uint8_t *>(jsWriterOptions.pixmapPtr);
+  } else {
+    if (pixmapBuffer.size() < size) pixmapBuffer.resize(size);
+    pixmap = pixmapBuffer.data();
+  }
+  std::memcpy(pixmap, written.data.data() + written.entry.pixmap.offset, size);
 
-    auto barcodeSymbol = barcode.symbol();
+  return {.data = val(typed_memory_view(size, pixmap)), .width = written.entry.pixmapWidth, .height = written.entry.pixmapHeight};
+}
 
-    return {
-      .svg = ZXing::WriteBarcodeToSVG(barcode, writerOptions),
-      .utf8 = ZXing::WriteBarcodeToUtf8(barcode, writerOptions),
-      .image = std::move(jsImage),
-      .symbol = createSymbolFromBarcodeSymbol(barcodeSymbol)
+// Converts the outputs selected in `jsWriterOptions.outputs`, the PNG and the symbol are copied into JS arrays.
+JsWriteResult createJsWriteResult(const WrittenBarcode &written, const JsWriterOptions &jsWriterOptions) {
+  const auto &[entry, data] = written;
+  auto bytes = [&data](const PackedSpan &span) { return typed_memory_view(span.length, data.data() + span.offset); };
+  auto text = [&data](const PackedSpan &span) { return std::string(reinterpret_cast<const char *>(data.data()) + span.offset, span.length); };
+  const int outputs = jsWriterOptions.outputs;
+
+  JsWriteResult jsWriteResult{.symbol = {.data = Uint8ClampedArray.new_(0)}};
+  if (outputs & WritePixmap) jsWriteResult.pixmap = writePixmap(written, jsWriterOptions);
+  if (outputs & WritePNG) jsWriteResult.image = Uint8Array.new_(val(bytes(entry.png)));
+  if (outputs & WriteSVG) jsWriteResult.svg = text(entry.svg);
+  if (outputs & WriteUtf8) jsWriteResult.utf8 = text(entry.utf8);
+  if (outputs & WriteSymbol) {
+    jsWriteResult.symbol = {
+      .data = Uint8ClampedArray.new_(val(bytes(entry.symbol))), .width = entry.symbolWidth, .height = entry.symbolHeight
     };
+  }
+  return jsWriteResult;
+}
+
+// Goes through writeCache, so repeated payloads come back without being created, rendered and encoded again
+JsWriteResult writeBarcodeCached(const char *payload, int length, bool isText, const JsWriterOptions &jsWriterOptions) {
+  try {
+    const auto &written = writeCache.write(
+      payload, length, isText, jsWriterOptions, createCreatorOptions(jsWriterOptions), createWriterOptions(jsWriterOptions)
+    );
+    return createJsWriteResult(written, jsWriterOptions);
   } catch (const std::exception &e) {
     return {.error = e.what()};
   } catch (...) {
@@ -485,34 +604,47 @@ JsWriteResult writeBarcodeFromText(std::string text, const JsWriterOptions &jsWr
   }
 }
 
-JsWriteResult writeBarcodeFromBytes(int bufferPtr, int bufferLength, const JsWriterOptions &jsWriterOptions) {
-  try {
-    auto barcode = ZXing::CreateBarcodeFromBytes(reinterpret_cast<const void *>(bufferPtr), bufferLength, createCreatorOptions(jsWriterOptions));
-    auto writerOptions = createWriterOptions(jsWriterOptions);
-
-    auto image = ZXing::WriteBarcodeToImage(barcode, writerOptions);
+JsWriteResult writeBarcodeFromText(std::string text, const JsWriterOptions &jsWriterOptions) {
+  return writeBarcodeCached(text.data(), static_cast<int>(text.size()), true, jsWriterOptions);
+}
 
-    int len;
-    uint8_t *bytes = stbi_write_png_to_mem(image.data(), image.rowStride(), image.width(), image.height(), ZXing::PixStride(image.format()), &len);
+JsWriteResult writeBarcodeFromBytes(int bufferPtr, int bufferLength, const JsWriterOptions &jsWriterOptions) {
+  return writeBarcodeCached(reinterpret_cast<const char *>(bufferPtr), bufferLength, false, jsWriterOptions);
+}
 
-    // Wrap into JS typed array *before* freeing.
-    val jsImage = Uint8Array.new_(val(typed_memory_view(len, bytes)));
+val getWriteCacheStats() {
+  const auto stats = writeCache.stats();
+  val jsStats = val::object();
+  jsStats.set("hits", stats.hits);
+  jsStats.set("misses", stats.misses);
+  jsStats.set("entries", stats.entries);
+  jsStats.set("bytes", stats.bytes);
+  jsStats.set("capacity", stats.capacity);
+  return jsStats;
+}
 
-    free(bytes); // Prevent leak – STBI allocates with malloc
+void setWriteCacheCapacity(double capacity) {
+  writeCache.setCapacity(static_cast<std::size_t>(std::max(capacity, 0.0)));
+}
 
-    auto barcodeSymbol = barcode.symbol();
+void purgeWriteCache() {
+  writeCache.purge();
+}
 
-    return {
-      .svg = ZXing::WriteBarcodeToSVG(barcode, writerOptions),
-      .utf8 = ZXing::WriteBarcodeToUtf8(barcode, writerOptions),
-      .image = std::move(jsImage),
-      .symbol = createSymbolFromBarcodeSymbol(barcodeSymbol)
-    };
-  } catch (const std::exception &e) {
-    return {.error = e.what()};
-  } catch (...) {
-    return {.error = "Unknown error"};
-  }
+// ------------------ Batch writer ------------------
+thread_local BatchWriter batchWriter;
+
+// Writes `count` barcodes whose payloads are stored back to back at `bufferPtr`, with the count + 1 int32
+// boundaries at `offsetsPtr` and one byte per payload at `isTextPtr`, non-zero for UTF-8 text.
+// Returns a view of the packed results, only valid until the next batch.
+val writeBarcodesFromPayloads(int bufferPtr, int offsetsPtr, int isTextPtr, int count, const JsWriterOptions &jsWriterOptions) {
+  return view(batchWriter.write(
+    reinterpret_cast<const uint8_t *>(bufferPtr),
+    reinterpret_cast<const int32_t *>(offsetsPtr),
+    reinterpret_cast<const uint8_t *>(isTextPtr),
+    count,
+    jsWriterOptions
+  ));
 }
 
 #endif
@@ -523,6 +655,24 @@ EMSCRIPTEN_BINDINGS(ZXingWasm) {
 
 #if defined(READER)
 
+#if defined(SCANX_THREADS)
+  splitFormatFamilies = !isBrowserMainThread();
+#endif
+
+  value_object<Rect>("Rect").field("x", &Rect::x).field("y", &Rect::y).field("width", &Rect::width).field("height", &Rect::height);
+
+  value_object<JsCascadeTier>("CascadeTier")
+    .field("tryHarder", &JsCascadeTier::tryHarder)
+    .field("tryRotate", &JsCascadeTier::tryRotate)
+    .field("tryInvert", &JsCascadeTier::tryInvert)
+    .field("tryDownscale", &JsCascadeTier::tryDownscale)
+    .field("tryDenoise", &JsCascadeTier::tryDenoise)
+    .field("binarizer", &JsCascadeTier::binarizer)
+    .field("isPure", &JsCascadeTier::isPure)
+    .field("downscaleThreshold", &JsCascadeTier::downscaleThreshold)
+    .field("downscaleFactor", &JsCascadeTier::downscaleFactor)
+    .field("minLineCount", &JsCascadeTier::minLineCount);
+
   value_object<JsReaderOptions>("ReaderOptions")
     .field("formats", &JsReaderOptions::formats)
     .field("tryHarder", &JsReaderOptions::tryHarder)
@@ -534,6 +684,10 @@ EMSCRIPTEN_BINDINGS(ZXingWasm) {
     .field("isPure", &JsReaderOptions::isPure)
     .field("downscaleThreshold", &JsReaderOptions::downscaleThreshold)
     .field("downscaleFactor", &JsReaderOptions::downscaleFactor)
+    .field("downscaleOnDecode", &JsReaderOptions::downscaleOnDecode)
+    .field("tileMemoryLimit", &JsReaderOptions::tileMemoryLimit)
+    .field("tileOverlap", &JsReaderOptions::tileOverlap)
+    .field("timeBudgetMs", &JsReaderOptions::timeBudgetMs)
     .field("minLineCount", &JsReaderOptions::minLineCount)
     .field("maxNumberOfSymbols", &JsReaderOptions::maxNumberOfSymbols)
     .field("tryCode39ExtendedMode", &JsReaderOptions::tryCode39ExtendedMode)
@@ -541,7 +695,10 @@ EMSCRIPTEN_BINDINGS(ZXingWasm) {
     .field("eanAddOnSymbol", &JsReaderOptions::eanAddOnSymbol)
     .field("textMode", &JsReaderOptions::textMode)
     .field("characterSet", &JsReaderOptions::characterSet)
-    .field("accessToken", &JsReaderOptions::accessToken); // add accessToken
+    .field("profile", &JsReaderOptions::profile)
+    .field("accessToken", &JsReaderOptions::accessToken) // add accessToken
+    .field("regions", &JsReaderOptions::regions)
+    .field("cascade", &JsReaderOptions::cascade);
 
   value_object<ZXing::PointI>("Point").field("x", &ZXing::PointI::x).field("y", &ZXing::PointI::y);
 
@@ -581,7 +738,41 @@ EMSCRIPTEN_BINDINGS(ZXingWasm) {
 
   function("readBarcodesFromImage", &readBarcodesFromImage);
   function("readBarcodesFromPixmap", &readBarcodesFromPixmap);
+  function("readBarcodesFromLuma", &readBarcodesFromLuma);
   function("readSingleBarcodeFromPixmap", &readSingleBarcodeFromPixmap);
+  function("readBarcodesFromImagePacked", &readBarcodesFromImagePacked);
+  function("readBarcodesFromPixmapPacked", &readBarcodesFromPixmapPacked);
+  function("readBarcodesFromLumaPacked", &readBarcodesFromLumaPacked);
+  function("readBarcodesFromImages", &readBarcodesFromImages);
+  function("readBarcodesFromFrames", &readBarcodesFromFrames);
+
+  value_object<ReadProfile>("ReadProfile")
+    .field("decodeMs", &ReadProfile::decodeMs)
+    .field("authMs", &ReadProfile::authMs)
+    .field("readMs", &ReadProfile::readMs)
+    .field("marshalMs", &ReadProfile::marshalMs);
+
+  function("getReadProfile", &getReadProfile);
+  function("getReaderStats", &getReaderStats);
+  function("resetReaderStats", &resetReaderStats);
+  function("getCascadeTier", &getCascadeTier);
+  function("getBudgetExceeded", &getBudgetExceeded);
+
+  class_<ReaderSession>("ReaderSession")
+    .constructor<const JsReaderOptions &>()
+    .function("setOptions", &ReaderSession::setOptions)
+    .function("inputBuffer", &ReaderSession::inputBuffer)
+    .function("readBarcodesFromImage", &ReaderSession::readBarcodesFromImage, return_value_policy::reference())
+    .function("readBarcodesFromPixmap", &ReaderSession::readBarcodesFromPixmap, return_value_policy::reference())
+    .function("readBarcodesFromLuma", &ReaderSession::readBarcodesFromLuma, return_value_policy::reference())
+    .function("readBarcodesFromImagePacked", &ReaderSession::readBarcodesFromImagePacked)
+    .function("readBarcodesFromPixmapPacked", &ReaderSession::readBarcodesFromPixmapPacked)
+    .function("readBarcodesFromLumaPacked", &ReaderSession::readBarcodesFromLumaPacked)
+    .function("setTracking", &ReaderSession::setTracking)
+    .function("trackIds", &ReaderSession::trackIds)
+    .function("setChangeDetection", &ReaderSession::setChangeDetection)
+    .function("frameUnchanged", &ReaderSession::frameUnchanged)
+    .function("changeDetectionStats", &ReaderSession::changeDetectionStats);
 
 #endif
 
@@ -596,17 +787,29 @@ EMSCRIPTEN_BINDINGS(ZXingWasm) {
     .field("rotate", &JsWriterOptions::rotate)
     .field("withHRT", &JsWriterOptions::withHRT)
     .field("withQuietZones", &JsWriterOptions::withQuietZones)
-    .field("options", &JsWriterOptions::options);
+    .field("options", &JsWriterOptions::options)
+    .field("outputs", &JsWriterOptions::outputs)
+    .field("pngCompressionLevel", &JsWriterOptions::pngCompressionLevel)
+    .field("pixmapFormat", &JsWriterOptions::pixmapFormat)
+    .field("pixmapPtr", &JsWriterOptions::pixmapPtr)
+    .field("pixmapCapacity", &JsWriterOptions::pixmapCapacity);
+
+  value_object<JsPixmap>("Pixmap").field("data", &JsPixmap::data).field("width", &JsPixmap::width).field("height", &JsPixmap::height);
 
   value_object<JsWriteResult>("WriteResult")
     .field("error", &JsWriteResult::error)
     .field("svg", &JsWriteResult::svg)
     .field("utf8", &JsWriteResult::utf8)
     .field("image", &JsWriteResult::image)
-    .field("symbol", &JsWriteResult::symbol);
+    .field("symbol", &JsWriteResult::symbol)
+    .field("pixmap", &JsWriteResult::pixmap);
 
   function("writeBarcodeFromText", &writeBarcodeFromText);
   function("writeBarcodeFromBytes", &writeBarcodeFromBytes);
+  function("writeBarcodesFromPayloads", &writeBarcodesFromPayloads);
+  function("getWriteCacheStats", &getWriteCacheStats);
+  function("setWriteCacheCapacity", &setWriteCacheCapacity);
+  function("purgeWriteCache", &purgeWriteCache);
 
 #endif
 };
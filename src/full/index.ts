@@ -1,18 +1,40 @@
 import type { Merge } from "type-fest";
-import type { ReaderOptions, WriterOptions } from "../bindings/index.js";
+import type {
+  PackedResultField,
+  ReaderOptions,
+  WriterOptions,
+} from "../bindings/index.js";
 import {
   type CDNHost,
+  createScannerSessionWithFactory,
+  type EncodedImage,
+  getReaderStatsWithFactory,
+  getWriteCacheStatsWithFactory,
   type PrepareScanXModuleOptions,
   prepareScanXModuleWithFactory,
+  prewarmScanXModuleWithFactory,
   purgeScanXModuleWithFactory,
+  purgeWriteCacheWithFactory,
+  type ReadFramesOptions,
+  type ReadInput,
+  readBarcodesFromFramesWithFactory,
+  readBarcodesFromImagesWithFactory,
+  readBarcodesPackedWithFactory,
   readBarcodesWithFactory,
   readSingleBarcodeWithFactory,
+  registerWasmFile,
+  resetReaderStatsWithFactory,
+  resolveWasmHash,
   type ScanXFullModule,
   type ScanXModuleOverrides,
+  setWriteCacheCapacityWithFactory,
+  writeBarcodesWithFactory,
   writeBarcodeWithFactory,
 } from "../share.js";
 import ScanXModuleFactory from "./scanx_full.js";
 
+registerWasmFile(ScanXModuleFactory, "scanx_full.wasm");
+
 export function prepareScanXModule(
   options?: Merge<PrepareScanXModuleOptions, { fireImmediately?: false }>,
 ): void;
@@ -29,6 +51,17 @@ export function prepareScanXModule(options?: PrepareScanXModuleOptions) {
   return prepareScanXModuleWithFactory(ScanXModuleFactory, options);
 }
 
+/**
+ * Downloads and compiles the module ahead of the first read or write, without instantiating it.
+ * Later instantiations reuse the compiled module, see
+ * {@link PrepareScanXModuleOptions.wasmCache | `wasmCache`}.
+ */
+export function prewarmScanXModule(
+  options?: Omit<PrepareScanXModuleOptions, "fireImmediately">,
+) {
+  return prewarmScanXModuleWithFactory(ScanXModuleFactory, options);
+}
+
 export function purgeScanXModule() {
   return purgeScanXModuleWithFactory(ScanXModuleFactory);
 }
@@ -76,7 +109,7 @@ export function setScanXModuleOverrides(
 }
 
 export async function readBarcodes(
-  input: Blob | ArrayBuffer | Uint8Array | ImageData,
+  input: ReadInput,
   readerOptions?: ReaderOptions,
   cdnHost?: CDNHost,
 ) {
@@ -87,8 +120,67 @@ export async function readBarcodes(
     cdnHost,
   );
 }
+/**
+ * Reads barcodes like {@link readBarcodes | `readBarcodes`}, but the results are packed into a
+ * single buffer inside the module and their fields are only decoded when accessed.
+ * Fields listed in `omitFields` are not produced at all.
+ */
+export async function readBarcodesPacked(
+  input: ReadInput,
+  readerOptions?: ReaderOptions,
+  omitFields?: PackedResultField[],
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesPackedWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    omitFields,
+    cdnHost,
+  );
+}
+/**
+ * Reads barcodes from many encoded images (PNG, JPEG, ...) in a single call into the module.
+ * Returns one array of results per image, in input order. An image that cannot be decoded or
+ * read only gets an error entry in its own results, the rest of the batch is still read.
+ * The results are packed like those of {@link readBarcodesPacked | `readBarcodesPacked`}.
+ */
+export async function readBarcodesFromImages(
+  inputs: EncodedImage[],
+  readerOptions?: ReaderOptions,
+  omitFields?: PackedResultField[],
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesFromImagesWithFactory(
+    ScanXModuleFactory,
+    inputs,
+    readerOptions,
+    omitFields,
+    cdnHost,
+  );
+}
+/**
+ * Reads barcodes from every frame of an animated GIF in a single call into the module. The frames
+ * are decoded at once and read in turn, other images are read as a single frame.
+ * Returns one array of results per frame, in frame order, packed like those of
+ * {@link readBarcodesPacked | `readBarcodesPacked`}.
+ */
+export async function readBarcodesFromFrames(
+  input: EncodedImage,
+  readerOptions?: ReaderOptions,
+  readFramesOptions?: ReadFramesOptions,
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesFromFramesWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    readFramesOptions,
+    cdnHost,
+  );
+}
 export async function readSingleBarcode(
-  input: Blob | ArrayBuffer | Uint8Array | ImageData,
+  input: ReadInput,
   readerOptions?: ReaderOptions,
   cdnHost?: CDNHost,
 ) {
@@ -100,6 +192,34 @@ export async function readSingleBarcode(
   );
 }
 
+/**
+ * Creates a {@link ScannerSession | `ScannerSession`} for repeatedly reading frames
+ * without reallocating the input buffer in the WASM heap on every call.
+ */
+export async function createScannerSession(
+  readerOptions?: ReaderOptions,
+  cdnHost?: CDNHost,
+) {
+  return createScannerSessionWithFactory(
+    ScanXModuleFactory,
+    readerOptions,
+    cdnHost,
+  );
+}
+/**
+ * Returns cumulative counters over every read of the module instance: the number of calls,
+ * the barcodes found and time spent per format, the heap high-water mark and the allocation count.
+ */
+export async function getReaderStats(cdnHost?: CDNHost) {
+  return getReaderStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+/**
+ * Resets the counters returned by {@link getReaderStats | `getReaderStats`}.
+ */
+export async function resetReaderStats(cdnHost?: CDNHost) {
+  return resetReaderStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+
 /**
  * @deprecated Use {@link readBarcodes | `readBarcodes`} instead.
  */
@@ -127,13 +247,67 @@ export async function writeBarcode(
   return writeBarcodeWithFactory(ScanXModuleFactory, input, writerOptions);
 }
 
+/**
+ * Generates one barcode per input like {@link writeBarcode | `writeBarcode`}, but in a single
+ * call into the module with the writer options converted only once.
+ * Results are returned in input order, a failing input only sets the `error` of its own result.
+ * Batches bypass the cache of {@link setWriteCacheCapacity | `setWriteCacheCapacity`}.
+ */
+export async function writeBarcodes(
+  inputs: (string | Uint8Array)[],
+  writerOptions?: WriterOptions,
+) {
+  return writeBarcodesWithFactory(ScanXModuleFactory, inputs, writerOptions);
+}
+
+/**
+ * Returns the counters of the cache of generated barcodes, see
+ * {@link setWriteCacheCapacity | `setWriteCacheCapacity`}.
+ */
+export async function getWriteCacheStats(cdnHost?: CDNHost) {
+  return getWriteCacheStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+
+/**
+ * Sets how many bytes of generated barcodes the module keeps, `0` turns the cache off.
+ * A payload written again by {@link writeBarcode | `writeBarcode`} with the same writer options is
+ * returned from the cache without being created, rendered or encoded again. The least recently used barcodes are evicted first.
+ * The cache holds 4 MiB by default.
+ */
+export async function setWriteCacheCapacity(
+  capacity: number,
+  cdnHost?: CDNHost,
+) {
+  return setWriteCacheCapacityWithFactory(
+    ScanXModuleFactory,
+    capacity,
+    cdnHost,
+  );
+}
+
+/**
+ * Drops every cached barcode and resets the counters, without purging the module itself.
+ * {@link purgeScanXModule | `purgeScanXModule`} drops them as well.
+ */
+export async function purgeWriteCache() {
+  return purgeWriteCacheWithFactory(ScanXModuleFactory);
+}
+
 export * from "../bindings/exposedReaderBindings.js";
 export * from "../bindings/exposedWriterBindings.js";
 export {
+  type ChangeDetectionStats,
+  type EncodedImage,
+  type LumImage,
   type PrepareScanXModuleOptions,
+  type ReadFramesOptions,
+  type ReadInput,
   SCANX_CPP_COMMIT,
   SCANX_WASM_VERSION,
   type ScanXFullModule,
   type ScanXModuleOverrides,
+  ScannerSession,
+  type SessionReadResult,
+  type WasmCacheOptions,
 } from "../share.js";
-export const SCANX_WASM_SHA256 = FULL_HASH;
+export const SCANX_WASM_SHA256 = resolveWasmHash(FULL_HASH, FULL_SIMD_HASH);
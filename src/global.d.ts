@@ -1,6 +1,17 @@
 /// <reference types="vite/client" />
 declare const NPM_PACKAGE_VERSION: string;
 declare const READER_HASH: string;
+declare const READER_SIMD_HASH: string;
+declare const READER_MT_HASH: string;
+declare const READER_MT_SIMD_HASH: string;
+declare const READER_QR_HASH: string;
+declare const READER_QR_SIMD_HASH: string;
+declare const READER_LINEAR_HASH: string;
+declare const READER_LINEAR_SIMD_HASH: string;
+declare const READER_MATRIX_HASH: string;
+declare const READER_MATRIX_SIMD_HASH: string;
 declare const WRITER_HASH: string;
+declare const WRITER_SIMD_HASH: string;
 declare const FULL_HASH: string;
+declare const FULL_SIMD_HASH: string;
 declare const SUBMODULE_COMMIT: string;
@@ -0,0 +1,318 @@
+/// <reference types="node" />
+import { availableParallelism } from "node:os";
+import { Worker, type WorkerOptions } from "node:worker_threads";
+import type {
+  ReaderOptions,
+  ReadResult,
+  WriterOptions,
+  WriteResult,
+} from "../bindings/index.js";
+import type {
+  CDNHost,
+  ReadInput,
+  ScanXModuleOverrides,
+  WasmCacheOptions,
+} from "../share.js";
+
+export interface ScanXPoolOptions {
+  /**
+   * Number of worker threads, each with its own instance of the full module.
+   * Workers are started on demand, up to this many.
+   *
+   * @defaultValue `os.availableParallelism()`
+   */
+  size?: number;
+  /**
+   * Maximum number of tasks waiting for a free worker.
+   * Reads and writes submitted while the queue is full are rejected right away,
+   * so a server can shed load instead of buffering inputs without bound.
+   *
+   * @defaultValue `Infinity`
+   */
+  maxQueueSize?: number;
+  /**
+   * Move the input buffers to the worker instead of copying them.
+   * The `ArrayBuffer` of a transferred input is detached and cannot be used after the call.
+   * Views that only cover part of their buffer (e.g. pooled Node `Buffer`s) are always copied.
+   *
+   * @defaultValue `false`
+   */
+  transferInputs?: boolean;
+  /**
+   * The Emscripten module overrides every worker instantiates its module with, e.g. a `wasmBinary`.
+   * They are sent to the workers by structured clone, so they cannot contain functions.
+   */
+  overrides?: ScanXModuleOverrides;
+  /**
+   * Custom CDN host URL the workers load the WASM file from, see
+   * {@link PrepareScanXModuleOptions.cdnHost | `PrepareScanXModuleOptions.cdnHost`}.
+   */
+  cdnHost?: CDNHost;
+  /**
+   * Whether the workers keep the downloaded `.wasm` file on disk, see
+   * {@link PrepareScanXModuleOptions.wasmCache | `PrepareScanXModuleOptions.wasmCache`}.
+   * Workers started later in the life of the pool then read it from disk instead of the network.
+   *
+   * @defaultValue `false`
+   */
+  wasmCache?: boolean | WasmCacheOptions;
+  /**
+   * Location of the worker script.
+   *
+   * @defaultValue The `worker.js` next to this module
+   */
+  workerUrl?: string | URL;
+  /**
+   * Extra options for every `Worker`, e.g. `resourceLimits`.
+   */
+  workerOptions?: Omit<WorkerOptions, "workerData">;
+}
+
+/**
+ * @internal
+ */
+export interface PoolWorkerData {
+  overrides?: ScanXModuleOverrides;
+  cdnHost?: CDNHost;
+  wasmCache?: boolean | WasmCacheOptions;
+}
+
+/**
+ * @internal
+ */
+export interface PoolRequest {
+  id: number;
+  method: "readBarcodes" | "writeBarcode";
+  args: unknown[];
+}
+
+interface PoolResponse {
+  id: number;
+  result?: unknown;
+  error?: unknown;
+}
+
+interface PoolTask extends PoolRequest {
+  transferList: ArrayBuffer[];
+  resolve: (result: never) => void;
+  reject: (error: unknown) => void;
+}
+
+/**
+ * The buffer backing `view`, if it can be moved to a worker without detaching unrelated data.
+ */
+function transferableBuffer(view: ArrayBufferView) {
+  return view.buffer instanceof ArrayBuffer &&
+    view.byteOffset === 0 &&
+    view.byteLength === view.buffer.byteLength
+    ? [view.buffer]
+    : [];
+}
+
+/**
+ * Turns a read input into one that survives structured cloning.
+ * `ImageData` is cloned as a plain object, which loses the accessors of polyfilled classes.
+ */
+function cloneableReadInput(input: ReadInput, transfer: boolean) {
+  let cloneable = input;
+  let data: ArrayBufferView | ArrayBuffer | undefined;
+  if ("format" in input) {
+    /* LumImage */
+    data = input.data;
+  } else if ("width" in input && "height" in input && "data" in input) {
+    /* ImageData */
+    const { data: pixels, width, height } = input;
+    cloneable = { data: pixels, width, height } as ImageData;
+    data = pixels;
+  } else if ("buffer" in input || "byteLength" in input) {
+    /* Uint8Array or ArrayBuffer */
+    data = input;
+  }
+  let transferList: ArrayBuffer[] = [];
+  if (transfer && data) {
+    transferList = ArrayBuffer.isView(data) ? transferableBuffer(data) : [data];
+  }
+  return { cloneable, transferList };
+}
+
+/**
+ * A pool of worker threads, each running its own instance of the full module.
+ *
+ * A single module instance reads synchronously, so all calls into it are serialized. The pool
+ * spreads {@link ScanXPool.readBarcodes | `readBarcodes`} and
+ * {@link ScanXPool.writeBarcode | `writeBarcode`} calls across its workers instead, so throughput
+ * scales with the number of cores. Tasks are queued in submission order while every worker is busy.
+ */
+export class ScanXPool {
+  #size: number;
+  #maxQueueSize: number;
+  #transferInputs: boolean;
+  #workerUrl: string | URL;
+  #workerOptions: WorkerOptions;
+  #workers = new Map<Worker, PoolTask | undefined>();
+  #queue: PoolTask[] = [];
+  #nextId = 0;
+  #terminated = false;
+
+  constructor({
+    size = availableParallelism(),
+    maxQueueSize = Number.POSITIVE_INFINITY,
+    transferInputs = false,
+    overrides,
+    cdnHost,
+    wasmCache,
+    workerUrl = new URL("./worker.js", import.meta.url),
+    workerOptions,
+  }: ScanXPoolOptions = {}) {
+    this.#size = Math.max(1, size);
+    this.#maxQueueSize = maxQueueSize;
+    this.#transferInputs = transferInputs;
+    this.#workerUrl = workerUrl;
+    this.#workerOptions = {
+      ...workerOptions,
+      workerData: { overrides, cdnHost, wasmCache } satisfies PoolWorkerData,
+    };
+  }
+
+  /**
+   * Number of tasks waiting for a free worker.
+   */
+  get queueSize() {
+    return this.#queue.length;
+  }
+
+  /**
+   * Reads barcodes like `readBarcodes` of `scanx-wasm/full`, on the next free worker.
+   */
+  readBarcodes(
+    input: ReadInput,
+    readerOptions?: ReaderOptions,
+  ): Promise<ReadResult[]> {
+    const { cloneable, transferList } = cloneableReadInput(
+      input,
+      this.#transferInputs,
+    );
+    return this.#submit<ReadResult[]>(
+      "readBarcodes",
+      [cloneable, readerOptions],
+      transferList,
+    );
+  }
+
+  /**
+   * Writes a barcode like `writeBarcode` of `scanx-wasm/full`, on the next free worker.
+   */
+  writeBarcode(
+    input: string | Uint8Array,
+    writerOptions?: WriterOptions,
+  ): Promise<WriteResult> {
+    const transferList =
+      this.#transferInputs && typeof input !== "string"
+        ? transferableBuffer(input)
+        : [];
+    return this.#submit<WriteResult>(
+      "writeBarcode",
+      [input, writerOptions],
+      transferList,
+    );
+  }
+
+  /**
+   * Stops every worker. Queued and running tasks are rejected.
+   */
+  async terminate() {
+    this.#terminated = true;
+    const error = new Error("ScanXPool has been terminated");
+    for (const task of this.#queue.splice(0)) task.reject(error);
+    const workers = [...this.#workers];
+    this.#workers.clear();
+    for (const [, task] of workers) task?.reject(error);
+    await Promise.all(workers.map(([worker]) => worker.terminate()));
+  }
+
+  #submit<R>(
+    method: PoolRequest["method"],
+    args: unknown[],
+    transferList: ArrayBuffer[],
+  ) {
+    return new Promise<R>((resolve, reject) => {
+      if (this.#terminated) {
+        reject(new Error("ScanXPool has been terminated"));
+        return;
+      }
+      const id = this.#nextId++;
+      this.#queue.push({ id, method, args, transferList, resolve, reject });
+      this.#dispatch();
+      // Still waiting for a worker, but there is no room left to wait in.
+      if (this.#queue.length > this.#maxQueueSize) {
+        this.#queue.pop();
+        reject(new Error("ScanXPool queue is full"));
+      }
+    });
+  }
+
+  #dispatch() {
+    while (this.#queue.length > 0) {
+      const worker = this.#idleWorker();
+      if (!worker) return;
+      const task = this.#queue.shift()!;
+      const { id, method, args, transferList } = task;
+      try {
+        worker.postMessage({ id, method, args }, transferList);
+      } catch (error) {
+        // E.g. a `DataCloneError` for an input that was already transferred, the worker stays idle.
+        task.reject(error);
+        continue;
+      }
+      this.#workers.set(worker, task);
+    }
+  }
+
+  #idleWorker() {
+    for (const [worker, task] of this.#workers) {
+      if (!task) return worker;
+    }
+    return this.#workers.size < this.#size ? this.#spawn() : undefined;
+  }
+
+  #spawn() {
+    const worker = new Worker(this.#workerUrl, this.#workerOptions);
+    worker.on("message", ({ id, result, error }: PoolResponse) => {
+      const task = this.#workers.get(worker);
+      if (task?.id !== id) return;
+      this.#workers.set(worker, undefined);
+      if (error === undefined) {
+        task.resolve(result as never);
+      } else {
+        task.reject(error);
+      }
+      this.#dispatch();
+    });
+    // A crashed worker only fails its own task, the next dispatch starts a replacement.
+    const onFailure = (error: unknown) => {
+      if (!this.#workers.has(worker)) return;
+      const task = this.#workers.get(worker);
+      this.#workers.delete(worker);
+      task?.reject(error);
+      this.#dispatch();
+    };
+    worker.on("error", onFailure);
+    worker.on("exit", (code) =>
+      onFailure(new Error(`ScanXPool worker exited with code ${code}`)),
+    );
+    this.#workers.set(worker, undefined);
+    return worker;
+  }
+}
+
+/**
+ * Creates a {@link ScanXPool | `ScanXPool`} of worker threads for reading and writing barcodes
+ * in parallel on Node.js.
+ */
+export function createScanXPool(poolOptions?: ScanXPoolOptions) {
+  return new ScanXPool(poolOptions);
+}
+
+export * from "../bindings/exposedReaderBindings.js";
+export * from "../bindings/exposedWriterBindings.js";
+export type { ReadInput, ScanXModuleOverrides } from "../share.js";
@@ -0,0 +1,53 @@
+/// <reference types="node" />
+import { parentPort, workerData } from "node:worker_threads";
+import {
+  prepareScanXModule,
+  readBarcodes,
+  writeBarcode,
+} from "../full/index.js";
+import type { PoolRequest, PoolWorkerData } from "./index.js";
+
+const { overrides, cdnHost, wasmCache } = workerData as PoolWorkerData;
+
+// Instantiate right away, so the first task does not pay for compiling the module.
+prepareScanXModule({
+  overrides,
+  cdnHost,
+  wasmCache,
+  equalityFn: Object.is,
+  fireImmediately: true,
+}).catch(() => {});
+
+const tasks = {
+  readBarcodes,
+  writeBarcode,
+};
+
+/**
+ * Collects the buffers of a result, so they are moved back to the main thread instead of copied.
+ */
+function resultBuffers(result: unknown, buffers = new Set<ArrayBuffer>()) {
+  if (ArrayBuffer.isView(result)) {
+    if (result.buffer instanceof ArrayBuffer) buffers.add(result.buffer);
+  } else if (Array.isArray(result)) {
+    for (const item of result) resultBuffers(item, buffers);
+  } else if (
+    result &&
+    typeof result === "object" &&
+    !(result instanceof Blob)
+  ) {
+    for (const value of Object.values(result)) resultBuffers(value, buffers);
+  }
+  return buffers;
+}
+
+parentPort?.on("message", async ({ id, method, args }: PoolRequest) => {
+  try {
+    const result = await (
+      tasks[method] as (...args: unknown[]) => Promise<unknown>
+    )(...args);
+    parentPort?.postMessage({ id, result }, [...resultBuffers(result)]);
+  } catch (error) {
+    parentPort?.postMessage({ id, error });
+  }
+});
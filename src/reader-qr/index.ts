@@ -0,0 +1,190 @@
+import type { Merge } from "type-fest";
+import type { PackedResultField, ReaderOptions } from "../bindings/index.js";
+// Only the QR Code readers of ZXing (QR Code, Micro QR Code and rMQR Code) are compiled into
+// this build. Other formats are never found, in exchange the module is smaller and starts faster.
+import ScanXModuleFactory from "../reader/scanx_reader_qr.js";
+import {
+  type CDNHost,
+  createScannerSessionWithFactory,
+  type EncodedImage,
+  getReaderStatsWithFactory,
+  type PrepareScanXModuleOptions,
+  prepareScanXModuleWithFactory,
+  prewarmScanXModuleWithFactory,
+  purgeScanXModuleWithFactory,
+  type ReadFramesOptions,
+  type ReadInput,
+  readBarcodesFromFramesWithFactory,
+  readBarcodesFromImagesWithFactory,
+  readBarcodesPackedWithFactory,
+  readBarcodesWithFactory,
+  readSingleBarcodeWithFactory,
+  registerWasmFile,
+  resetReaderStatsWithFactory,
+  resolveWasmHash,
+  type ScanXReaderModule,
+} from "../share.js";
+
+registerWasmFile(ScanXModuleFactory, "scanx_reader_qr.wasm");
+
+export function prepareScanXModule(
+  options?: Merge<PrepareScanXModuleOptions, { fireImmediately?: false }>,
+): void;
+
+export function prepareScanXModule(
+  options: Merge<PrepareScanXModuleOptions, { fireImmediately: true }>,
+): Promise<ScanXReaderModule>;
+
+export function prepareScanXModule(
+  options?: PrepareScanXModuleOptions,
+): void | Promise<ScanXReaderModule>;
+
+export function prepareScanXModule(options?: PrepareScanXModuleOptions) {
+  return prepareScanXModuleWithFactory(ScanXModuleFactory, options);
+}
+
+/**
+ * Downloads and compiles the module ahead of the first read or write, without instantiating it.
+ * Later instantiations reuse the compiled module, see
+ * {@link PrepareScanXModuleOptions.wasmCache | `wasmCache`}.
+ */
+export function prewarmScanXModule(
+  options?: Omit<PrepareScanXModuleOptions, "fireImmediately">,
+) {
+  return prewarmScanXModuleWithFactory(ScanXModuleFactory, options);
+}
+
+export function purgeScanXModule() {
+  return purgeScanXModuleWithFactory(ScanXModuleFactory);
+}
+
+export async function readBarcodes(
+  input: ReadInput,
+  readerOptions?: ReaderOptions,
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    cdnHost,
+  );
+}
+/**
+ * Reads barcodes like {@link readBarcodes | `readBarcodes`}, but the results are packed into a
+ * single buffer inside the module and their fields are only decoded when accessed.
+ * Fields listed in `omitFields` are not produced at all.
+ */
+export async function readBarcodesPacked(
+  input: ReadInput,
+  readerOptions?: ReaderOptions,
+  omitFields?: PackedResultField[],
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesPackedWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    omitFields,
+    cdnHost,
+  );
+}
+/**
+ * Reads barcodes from many encoded images (PNG, JPEG, ...) in a single call into the module.
+ * Returns one array of results per image, in input order. An image that cannot be decoded or
+ * read only gets an error entry in its own results, the rest of the batch is still read.
+ * The results are packed like those of {@link readBarcodesPacked | `readBarcodesPacked`}.
+ */
+export async function readBarcodesFromImages(
+  inputs: EncodedImage[],
+  readerOptions?: ReaderOptions,
+  omitFields?: PackedResultField[],
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesFromImagesWithFactory(
+    ScanXModuleFactory,
+    inputs,
+    readerOptions,
+    omitFields,
+    cdnHost,
+  );
+}
+/**
+ * Reads barcodes from every frame of an animated GIF in a single call into the module. The frames
+ * are decoded at once and read in turn, other images are read as a single frame.
+ * Returns one array of results per frame, in frame order, packed like those of
+ * {@link readBarcodesPacked | `readBarcodesPacked`}.
+ */
+export async function readBarcodesFromFrames(
+  input: EncodedImage,
+  readerOptions?: ReaderOptions,
+  readFramesOptions?: ReadFramesOptions,
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesFromFramesWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    readFramesOptions,
+    cdnHost,
+  );
+}
+export async function readSingleBarcode(
+  input: ReadInput,
+  readerOptions?: ReaderOptions,
+  cdnHost?: CDNHost,
+) {
+  return readSingleBarcodeWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    cdnHost,
+  );
+}
+/**
+ * Creates a {@link ScannerSession | `ScannerSession`} for repeatedly reading frames
+ * without reallocating the input buffer in the WASM heap on every call.
+ */
+export async function createScannerSession(
+  readerOptions?: ReaderOptions,
+  cdnHost?: CDNHost,
+) {
+  return createScannerSessionWithFactory(
+    ScanXModuleFactory,
+    readerOptions,
+    cdnHost,
+  );
+}
+/**
+ * Returns cumulative counters over every read of the module instance: the number of calls,
+ * the barcodes found and time spent per format, the heap high-water mark and the allocation count.
+ */
+export async function getReaderStats(cdnHost?: CDNHost) {
+  return getReaderStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+/**
+ * Resets the counters returned by {@link getReaderStats | `getReaderStats`}.
+ */
+export async function resetReaderStats(cdnHost?: CDNHost) {
+  return resetReaderStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+
+export * from "../bindings/exposedReaderBindings.js";
+export {
+  type EncodedImage,
+  type LumImage,
+  type PrepareScanXModuleOptions,
+  type ReadFramesOptions,
+  type ReadInput,
+  SCANX_CPP_COMMIT,
+  SCANX_WASM_VERSION,
+  type ScanXModuleOverrides,
+  type ScanXReaderModule,
+  ScannerSession,
+  type SessionReadResult,
+  type WasmCacheOptions,
+} from "../share.js";
+export const SCANX_WASM_SHA256 = resolveWasmHash(
+  READER_QR_HASH,
+  READER_QR_SIMD_HASH,
+);
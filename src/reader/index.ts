@@ -1,16 +1,41 @@
 import type { Merge } from "type-fest";
-import type { ReaderOptions } from "../bindings/index.js";
+import type { PackedResultField, ReaderOptions } from "../bindings/index.js";
 import {
   type CDNHost,
+  createScannerSessionWithFactory,
+  type EncodedImage,
+  getReaderStatsWithFactory,
   type PrepareScanXModuleOptions,
   prepareScanXModuleWithFactory,
+  prewarmScanXModuleWithFactory,
   purgeScanXModuleWithFactory,
+  type ReadFramesOptions,
+  type ReadInput,
+  readBarcodesFromFramesWithFactory,
+  readBarcodesFromImagesWithFactory,
+  readBarcodesPackedWithFactory,
   readBarcodesWithFactory,
   readSingleBarcodeWithFactory,
+  registerWasmFile,
+  resetReaderStatsWithFactory,
+  resolveWasmHash,
   type ScanXModuleOverrides,
   type ScanXReaderModule,
+  supportsThreads,
 } from "../share.js";
-import ScanXModuleFactory from "./scanx_reader.js";
+import ScanXReaderModuleFactory from "./scanx_reader.js";
+import ScanXReaderMTModuleFactory from "./scanx_reader_mt.js";
+
+registerWasmFile(ScanXReaderModuleFactory, "scanx_reader.wasm");
+registerWasmFile(ScanXReaderMTModuleFactory, "scanx_reader_mt.wasm");
+
+/**
+ * The multithreaded build reads format families and batch images in parallel,
+ * it is picked whenever shared memory can be used.
+ */
+const ScanXModuleFactory = supportsThreads()
+  ? ScanXReaderMTModuleFactory
+  : ScanXReaderModuleFactory;
 
 export function prepareScanXModule(
   options?: Merge<PrepareScanXModuleOptions, { fireImmediately?: false }>,
@@ -28,6 +53,17 @@ export function prepareScanXModule(options?: PrepareScanXModuleOptions) {
   return prepareScanXModuleWithFactory(ScanXModuleFactory, options);
 }
 
+/**
+ * Downloads and compiles the module ahead of the first read or write, without instantiating it.
+ * Later instantiations reuse the compiled module, see
+ * {@link PrepareScanXModuleOptions.wasmCache | `wasmCache`}.
+ */
+export function prewarmScanXModule(
+  options?: Omit<PrepareScanXModuleOptions, "fireImmediately">,
+) {
+  return prewarmScanXModuleWithFactory(ScanXModuleFactory, options);
+}
+
 export function purgeScanXModule() {
   return purgeScanXModuleWithFactory(ScanXModuleFactory);
 }
@@ -75,7 +111,7 @@ export function setScanXModuleOverrides(
 }
 
 export async function readBarcodes(
-  input: Blob | ArrayBuffer | Uint8Array | ImageData,
+  input: ReadInput,
   readerOptions?: ReaderOptions,
   cdnHost?: CDNHost,
 ) {
@@ -86,8 +122,67 @@ export async function readBarcodes(
     cdnHost,
   );
 }
+/**
+ * Reads barcodes like {@link readBarcodes | `readBarcodes`}, but the results are packed into a
+ * single buffer inside the module and their fields are only decoded when accessed.
+ * Fields listed in `omitFields` are not produced at all.
+ */
+export async function readBarcodesPacked(
+  input: ReadInput,
+  readerOptions?: ReaderOptions,
+  omitFields?: PackedResultField[],
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesPackedWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    omitFields,
+    cdnHost,
+  );
+}
+/**
+ * Reads barcodes from many encoded images (PNG, JPEG, ...) in a single call into the module.
+ * Returns one array of results per image, in input order. An image that cannot be decoded or
+ * read only gets an error entry in its own results, the rest of the batch is still read.
+ * The results are packed like those of {@link readBarcodesPacked | `readBarcodesPacked`}.
+ */
+export async function readBarcodesFromImages(
+  inputs: EncodedImage[],
+  readerOptions?: ReaderOptions,
+  omitFields?: PackedResultField[],
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesFromImagesWithFactory(
+    ScanXModuleFactory,
+    inputs,
+    readerOptions,
+    omitFields,
+    cdnHost,
+  );
+}
+/**
+ * Reads barcodes from every frame of an animated GIF in a single call into the module. The frames
+ * are decoded at once and read in turn, other images are read as a single frame.
+ * Returns one array of results per frame, in frame order, packed like those of
+ * {@link readBarcodesPacked | `readBarcodesPacked`}.
+ */
+export async function readBarcodesFromFrames(
+  input: EncodedImage,
+  readerOptions?: ReaderOptions,
+  readFramesOptions?: ReadFramesOptions,
+  cdnHost?: CDNHost,
+) {
+  return readBarcodesFromFramesWithFactory(
+    ScanXModuleFactory,
+    input,
+    readerOptions,
+    readFramesOptions,
+    cdnHost,
+  );
+}
 export async function readSingleBarcode(
-  input: Blob | ArrayBuffer | Uint8Array | ImageData,
+  input: ReadInput,
   readerOptions?: ReaderOptions,
   cdnHost?: CDNHost,
 ) {
@@ -98,6 +193,34 @@ export async function readSingleBarcode(
     cdnHost,
   );
 }
+/**
+ * Creates a {@link ScannerSession | `ScannerSession`} for repeatedly reading frames
+ * without reallocating the input buffer in the WASM heap on every call.
+ */
+export async function createScannerSession(
+  readerOptions?: ReaderOptions,
+  cdnHost?: CDNHost,
+) {
+  return createScannerSessionWithFactory(
+    ScanXModuleFactory,
+    readerOptions,
+    cdnHost,
+  );
+}
+/**
+ * Returns cumulative counters over every read of the module instance: the number of calls,
+ * the barcodes found and time spent per format, the heap high-water mark and the allocation count.
+ */
+export async function getReaderStats(cdnHost?: CDNHost) {
+  return getReaderStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+/**
+ * Resets the counters returned by {@link getReaderStats | `getReaderStats`}.
+ */
+export async function resetReaderStats(cdnHost?: CDNHost) {
+  return resetReaderStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+
 /**
  * @deprecated Use {@link readBarcodes | `readBarcodes`} instead.
  */
@@ -122,10 +245,20 @@ export async function readBarcodesFromImageData(
 
 export * from "../bindings/exposedReaderBindings.js";
 export {
+  type ChangeDetectionStats,
+  type EncodedImage,
+  type LumImage,
   type PrepareScanXModuleOptions,
+  type ReadFramesOptions,
+  type ReadInput,
   SCANX_CPP_COMMIT,
   SCANX_WASM_VERSION,
   type ScanXModuleOverrides,
   type ScanXReaderModule,
+  ScannerSession,
+  type SessionReadResult,
+  type WasmCacheOptions,
 } from "../share.js";
-export const SCANX_WASM_SHA256 = READER_HASH;
+export const SCANX_WASM_SHA256 = supportsThreads()
+  ? resolveWasmHash(READER_MT_HASH, READER_MT_SIMD_HASH)
+  : resolveWasmHash(READER_HASH, READER_SIMD_HASH);
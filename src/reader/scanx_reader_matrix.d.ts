@@ -0,0 +1,4 @@
+import type { ScanXReaderModuleFactory } from "../share.js";
+
+declare const ScanX: ScanXReaderModuleFactory;
+export default ScanX;
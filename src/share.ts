@@ -2,26 +2,79 @@ import type { Merge } from "type-fest";
 import {
   defaultReaderOptions,
   defaultWriterOptions,
+  encodePackedResultFields,
+  type PackedResultField,
+  type ProfiledReadResults,
   type ReaderOptions,
   type ReadResult,
   readerOptionsToScanXReaderOptions,
   type ScanXReaderOptions,
+  type ScanXReaderStats,
+  ScanXReaderStatsToReaderStats,
+  type ScanXReadProfile,
   type ScanXReadResult,
   ScanXReadResultToReadResult,
   type ScanXVector,
   type ScanXWriteResult,
   ScanXWriteResultToWriteResult,
   type ScanXWriterOptions,
+  unpackBatchReadResults,
+  unpackReadResults,
+  unpackWriteResults,
+  type WriteCacheStats,
   type WriterOptions,
   writerOptionsToScanXWriterOptions,
 } from "./bindings/index.js";
+import { compileWasm, isNode, type WasmCacheOptions } from "./wasmCache.js";
+
+export type { WasmCacheOptions } from "./wasmCache.js";
 
 export type ScanXModuleType = "reader" | "writer" | "full";
 
+/**
+ * @internal
+ */
+export interface ScanXReaderSession {
+  setOptions(ScanXReaderOptions: ScanXReaderOptions): void;
+  inputBuffer(size: number): number;
+  readBarcodesFromImage(bufferLength: number): ScanXVector<ScanXReadResult>;
+  readBarcodesFromPixmap(
+    imgWidth: number,
+    imgHeight: number,
+  ): ScanXVector<ScanXReadResult>;
+  readBarcodesFromLuma(
+    imgWidth: number,
+    imgHeight: number,
+    rowStride: number,
+  ): ScanXVector<ScanXReadResult>;
+  readBarcodesFromImagePacked(bufferLength: number, fields: number): Uint8Array;
+  readBarcodesFromPixmapPacked(
+    imgWidth: number,
+    imgHeight: number,
+    fields: number,
+  ): Uint8Array;
+  readBarcodesFromLumaPacked(
+    imgWidth: number,
+    imgHeight: number,
+    rowStride: number,
+    fields: number,
+  ): Uint8Array;
+  setTracking(fullScanInterval: number): void;
+  trackIds(): Int32Array;
+  setChangeDetection(threshold: number): void;
+  frameUnchanged(): boolean;
+  changeDetectionStats(): ChangeDetectionStats;
+  delete(): void;
+}
+
 /**
  * @internal
  */
 export interface ScanXReaderModule extends EmscriptenModule {
+  ReaderSession: new (
+    ScanXReaderOptions: ScanXReaderOptions,
+  ) => ScanXReaderSession;
+
   readBarcodesFromImage(
     bufferPtr: number,
     bufferLength: number,
@@ -34,12 +87,59 @@ export interface ScanXReaderModule extends EmscriptenModule {
     imgHeight: number,
     ScanXReaderOptions: ScanXReaderOptions,
   ): ScanXVector<ScanXReadResult>;
+  readBarcodesFromLuma(
+    bufferPtr: number,
+    imgWidth: number,
+    imgHeight: number,
+    rowStride: number,
+    ScanXReaderOptions: ScanXReaderOptions,
+  ): ScanXVector<ScanXReadResult>;
   readSingleBarcodeFromPixmap(
     bufferPtr: number,
     imgWidth: number,
     imgHeight: number,
     ScanXReaderOptions: ScanXReaderOptions,
   ): ScanXReadResult;
+  readBarcodesFromImagePacked(
+    bufferPtr: number,
+    bufferLength: number,
+    ScanXReaderOptions: ScanXReaderOptions,
+    fields: number,
+  ): Uint8Array;
+  readBarcodesFromPixmapPacked(
+    bufferPtr: number,
+    imgWidth: number,
+    imgHeight: number,
+    ScanXReaderOptions: ScanXReaderOptions,
+    fields: number,
+  ): Uint8Array;
+  readBarcodesFromLumaPacked(
+    bufferPtr: number,
+    imgWidth: number,
+    imgHeight: number,
+    rowStride: number,
+    ScanXReaderOptions: ScanXReaderOptions,
+    fields: number,
+  ): Uint8Array;
+  readBarcodesFromImages(
+    bufferPtr: number,
+    offsetsPtr: number,
+    count: number,
+    ScanXReaderOptions: ScanXReaderOptions,
+    fields: number,
+  ): Uint8Array;
+  readBarcodesFromFrames(
+    bufferPtr: number,
+    bufferLength: number,
+    ScanXReaderOptions: ScanXReaderOptions,
+    fields: number,
+    stopAtFirstCode: boolean,
+  ): Uint8Array;
+  getReadProfile(): ScanXReadProfile;
+  getCascadeTier(): number;
+  getBudgetExceeded(): boolean;
+  getReaderStats(): ScanXReaderStats;
+  resetReaderStats(): void;
 }
 
 /**
@@ -56,6 +156,18 @@ export interface ScanXWriterModule extends EmscriptenModule {
     bufferLength: number,
     ScanXWriterOptions: ScanXWriterOptions,
   ): ScanXWriteResult;
+
+  writeBarcodesFromPayloads(
+    bufferPtr: number,
+    offsetsPtr: number,
+    isTextPtr: number,
+    count: number,
+    ScanXWriterOptions: ScanXWriterOptions,
+  ): Uint8Array;
+
+  getWriteCacheStats(): WriteCacheStats;
+  setWriteCacheCapacity(capacity: number): void;
+  purgeWriteCache(): void;
 }
 
 /**
@@ -89,6 +201,59 @@ export const SCANX_WASM_VERSION = NPM_PACKAGE_VERSION;
 
 export const SCANX_CPP_COMMIT = SUBMODULE_COMMIT;
 export type CDNHost = string | undefined | null;
+
+/**
+ * Whether the multithreaded build can be used. Its memory is a `SharedArrayBuffer` shared with
+ * web workers, which browsers only allow in cross-origin isolated contexts. Node.js has no such
+ * restriction and runs the threads on worker threads.
+ */
+export function supportsThreads() {
+  return (
+    typeof SharedArrayBuffer !== "undefined" &&
+    (globalThis.crossOriginIsolated === true || isNode())
+  );
+}
+
+let simdSupport: boolean | undefined;
+
+/**
+ * Whether the engine supports WebAssembly SIMD128, checked once by validating
+ * a minimal module that uses a SIMD instruction.
+ */
+export function supportsSimd() {
+  simdSupport ??= WebAssembly.validate(
+    new Uint8Array([
+      0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10,
+      1, 8, 0, 65, 0, 253, 15, 253, 98, 11,
+    ]),
+  );
+  return simdSupport;
+}
+
+/**
+ * The `.wasm` file to load in place of `path`: its SIMD variant if the engine
+ * supports SIMD, otherwise `path` itself. Both variants share the same JS glue.
+ */
+function resolveWasmVariant(path: string) {
+  return supportsSimd() ? path.replace(/\.wasm$/, "_simd.wasm") : path;
+}
+
+/**
+ * The SHA-256 of the `.wasm` variant {@link resolveWasmVariant | `resolveWasmVariant`} picks,
+ * from the hashes of the scalar and the SIMD build.
+ *
+ * @internal
+ */
+export function resolveWasmHash(hash: string, simdHash: string) {
+  return supportsSimd() ? simdHash : hash;
+}
+
+/**
+ * Captures the directory of a `.wasm` file from its name, e.g. `reader` for `scanx_reader.wasm`.
+ * The multithreaded and slim reader builds live next to `scanx_reader.wasm`.
+ */
+const WASM_PATH_PATTERN = /_([^_]+?)(?:_mt|_qr|_linear|_matrix)?\.wasm$/;
+
 const getDefaultModuleOverrides = (cdnHost?: CDNHost) => {
   const DEFAULT_MODULE_OVERRIDES: ScanXModuleOverrides =
     import.meta.env.MODE === "miniprogram"
@@ -120,18 +285,18 @@ const getDefaultModuleOverrides = (cdnHost?: CDNHost) => {
       : import.meta.env.PROD
         ? {
             locateFile: (path, prefix) => {
-              const match = path.match(/_(.+?)\.wasm$/);
+              const match = path.match(WASM_PATH_PATTERN);
               if (match) {
-                return `${cdnHost || `https://fastly.jsdelivr.net/npm/scanx-wasm@${NPM_PACKAGE_VERSION}`}/dist/${match[1]}/${path}`;
+                return `${cdnHost || `https://fastly.jsdelivr.net/npm/scanx-wasm@${NPM_PACKAGE_VERSION}`}/dist/${match[1]}/${resolveWasmVariant(path)}`;
               }
               return prefix + path;
             },
           }
         : {
             locateFile: (path, prefix) => {
-              const match = path.match(/_(.+?)\.wasm$/);
+              const match = path.match(WASM_PATH_PATTERN);
               if (match) {
-                return `/src/${match[1]}/${path}`;
+                return `/src/${match[1]}/${resolveWasmVariant(path)}`;
               }
               return prefix + path;
             },
@@ -146,6 +311,30 @@ type CachedValue<T extends ScanXModuleType = ScanXModuleType> =
 
 const __CACHE__ = new WeakMap<ScanXModuleFactory, CachedValue>();
 
+/**
+ * The `.wasm` file of every factory, registered by the entry that imports it.
+ */
+const __WASM_FILES__ = new WeakMap<ScanXModuleFactory, string>();
+
+/**
+ * Factories that are instantiated from a module compiled by `compileWasm`, and whether the
+ * `.wasm` file is kept across page loads / process starts.
+ */
+const __WASM_CACHE__ = new WeakMap<
+  ScanXModuleFactory,
+  WasmCacheOptions | false
+>();
+
+/**
+ * @internal
+ */
+export function registerWasmFile(
+  ScanXModuleFactory: ScanXModuleFactory,
+  wasmFile: string,
+) {
+  __WASM_FILES__.set(ScanXModuleFactory, wasmFile);
+}
+
 export interface PrepareScanXModuleOptions {
   /**
    * The Emscripten module overrides to be passed to the factory function.
@@ -176,6 +365,27 @@ export interface PrepareScanXModuleOptions {
    * @default false
    */
   fireImmediately?: boolean;
+  /**
+   * Whether to cache the `.wasm` file and its compiled `WebAssembly.Module`.
+   *
+   * The module is compiled once per page or process and reused whenever it is instantiated again,
+   * e.g. after {@link purgeScanXModule | `purgeScanXModule`} or with other overrides. The `.wasm`
+   * file is also kept across page loads and process starts, keyed by
+   * {@link SCANX_WASM_VERSION | `SCANX_WASM_VERSION`} and {@link SCANX_CPP_COMMIT | `SCANX_CPP_COMMIT`}:
+   *
+   * - In browsers, the response is stored with the Cache API and compiled with
+   *   `WebAssembly.compileStreaming`. Engines that keep the compiled code of cached responses
+   *   (V8) skip most of the compilation on the next page load.
+   * - In Node.js, downloaded files are stored in {@link WasmCacheOptions.directory | `directory`}.
+   *   Local files (paths and `file:` URLs returned by `locateFile`) are read in place.
+   *
+   * The `.wasm` URL is resolved with `locateFile(wasmFile, "")`. Overrides that provide their own
+   * `wasmBinary` or `instantiateWasm` are left alone. Setting it to `false` turns caching off again
+   * for the next instantiation.
+   *
+   * @defaultValue `false`
+   */
+  wasmCache?: boolean | WasmCacheOptions;
 }
 
 /**
@@ -249,8 +459,15 @@ export function prepareScanXModuleWithFactory<T extends ScanXModuleType>(
     equalityFn = shallow,
     fireImmediately = false,
     cdnHost,
+    wasmCache,
   }: PrepareScanXModuleOptions = {},
 ) {
+  if (wasmCache === false) {
+    __WASM_CACHE__.delete(ScanXModuleFactory);
+  } else if (wasmCache !== undefined) {
+    __WASM_CACHE__.set(ScanXModuleFactory, wasmCache === true ? {} : wasmCache);
+  }
+
   // look up the cached overrides and module promise
   const [cachedOverrides, cachedPromise] = (__CACHE__.get(ScanXModuleFactory) as
     | CachedValue<T>
@@ -272,9 +489,10 @@ export function prepareScanXModuleWithFactory<T extends ScanXModuleType>(
       return cachedPromise;
     }
     // otherwise, instantiate the module
-    const modulePromise = ScanXModuleFactory({
-      ...resolvedOverrides,
-    }) as Promise<ScanXModule<T>>;
+    const modulePromise = instantiateScanXModule(
+      ScanXModuleFactory,
+      resolvedOverrides,
+    );
     // cache the overrides and the promise
     __CACHE__.set(ScanXModuleFactory, [resolvedOverrides, modulePromise]);
     // and return the promise
@@ -287,6 +505,88 @@ export function prepareScanXModuleWithFactory<T extends ScanXModuleType>(
   }
 }
 
+/**
+ * The URL of the `.wasm` file of a factory, if it is to be instantiated from a compiled module.
+ */
+function locateCompiledWasm(
+  ScanXModuleFactory: ScanXModuleFactory,
+  overrides: ScanXModuleOverrides,
+) {
+  const wasmFile = __WASM_FILES__.get(ScanXModuleFactory);
+  if (!wasmFile || overrides.wasmBinary || overrides.instantiateWasm) {
+    return undefined;
+  }
+  return overrides.locateFile?.(wasmFile, "") ?? wasmFile;
+}
+
+/**
+ * Instantiates a module, from the compiled module of `compileWasm` if `wasmCache` is enabled.
+ * Compiling happens before calling the factory, so a failed download rejects the module promise.
+ */
+async function instantiateScanXModule<T extends ScanXModuleType>(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  overrides: ScanXModuleOverrides,
+) {
+  const persist = __WASM_CACHE__.get(ScanXModuleFactory);
+  const url = locateCompiledWasm(ScanXModuleFactory, overrides);
+  if (persist === undefined || url === undefined) {
+    return ScanXModuleFactory({ ...overrides }) as Promise<ScanXModule<T>>;
+  }
+  const wasmModule = await compileWasm(url, persist);
+  // Emscripten only catches what `instantiateWasm` throws synchronously, a failed instantiation
+  // (e.g. a `LinkError` or running out of memory) has to reject the module promise from here.
+  return new Promise<ScanXModule<T>>((resolve, reject) => {
+    (
+      ScanXModuleFactory({
+        ...overrides,
+        instantiateWasm(imports, successCallback) {
+          // Emscripten also takes the module, the multithreaded builds hand it to their workers.
+          const receiveInstance = successCallback as (
+            instance: WebAssembly.Instance,
+            module: WebAssembly.Module,
+          ) => void;
+          WebAssembly.instantiate(wasmModule, imports)
+            .then((instance) => receiveInstance(instance, wasmModule))
+            .catch(reject);
+          return {};
+        },
+      }) as Promise<ScanXModule<T>>
+    ).then(resolve, reject);
+  });
+}
+
+/**
+ * Compiles the module of a factory ahead of its first use, without instantiating it.
+ *
+ * @param ScanXModuleFactory - Factory function of the ScanX module
+ * @param options - Overrides, CDN host and `wasmCache` like for `prepareScanXModuleWithFactory`
+ *
+ * @remarks
+ * Instantiations of the factory reuse the compiled module from then on, as with `wasmCache`.
+ * Nothing is compiled if the overrides provide their own `wasmBinary` or `instantiateWasm`.
+ */
+export async function prewarmScanXModuleWithFactory<
+  T extends ScanXModuleType,
+>(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  options: Omit<PrepareScanXModuleOptions, "fireImmediately"> = {},
+) {
+  prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    ...options,
+    fireImmediately: false,
+  });
+  if (!__WASM_CACHE__.has(ScanXModuleFactory)) {
+    __WASM_CACHE__.set(ScanXModuleFactory, false);
+  }
+  const overrides =
+    __CACHE__.get(ScanXModuleFactory)?.[0] ??
+    getDefaultModuleOverrides(options.cdnHost);
+  const url = locateCompiledWasm(ScanXModuleFactory, overrides);
+  if (url !== undefined) {
+    await compileWasm(url, __WASM_CACHE__.get(ScanXModuleFactory) ?? false);
+  }
+}
+
 /**
  * Removes a ScanX module instance from the internal cache.
  *
@@ -298,14 +598,192 @@ export function prepareScanXModuleWithFactory<T extends ScanXModuleType>(
 export function purgeScanXModuleWithFactory<T extends ScanXModuleType>(
   ScanXModuleFactory: ScanXModuleFactory<T>,
 ) {
+  // The instance may still be held elsewhere (e.g. by a ScannerSession), so drop what it caches now.
+  __CACHE__.get(ScanXModuleFactory)?.[1]?.then(
+    (ScanXModule) => {
+      if ("purgeWriteCache" in ScanXModule) ScanXModule.purgeWriteCache();
+    },
+    () => {},
+  );
   __CACHE__.delete(ScanXModuleFactory);
 }
 
+/**
+ * A single-channel luma image, or a planar / semi-planar YUV frame whose Y plane comes first.
+ *
+ * Only the Y plane is copied into the WASM heap and read, the chroma planes of `"NV12"` and
+ * `"I420"` frames are ignored. This is the layout produced by e.g. `VideoFrame.copyTo()`.
+ */
+export interface LumImage {
+  /**
+   * Pixel data starting with the Y plane.
+   */
+  data: Uint8Array | Uint8ClampedArray;
+  /**
+   * Width of the image in pixels.
+   */
+  width: number;
+  /**
+   * Height of the image in pixels.
+   */
+  height: number;
+  /**
+   * Distance in bytes between the starts of two consecutive rows of the Y plane.
+   *
+   * @defaultValue `width`
+   */
+  rowStride?: number;
+  /**
+   * Pixel layout of `data`.
+   */
+  format: "Lum" | "NV12" | "I420";
+}
+
+export type ReadInput = Blob | ArrayBuffer | Uint8Array | ImageData | LumImage;
+
+type ResolvedReadInput =
+  | { type: "pixmap"; buffer: Uint8ClampedArray; width: number; height: number }
+  | {
+      type: "lum";
+      buffer: Uint8Array | Uint8ClampedArray;
+      width: number;
+      height: number;
+      rowStride: number;
+    }
+  | { type: "image"; buffer: Uint8Array };
+
+/**
+ * Normalizes the accepted read inputs into an RGBA pixmap, a luma plane or an encoded image buffer.
+ *
+ * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, ImageData, or LumImage
+ * @returns The bytes to be copied into the module heap, tagged with how they should be read
+ */
+async function resolveReadInput(input: ReadInput): Promise<ResolvedReadInput> {
+  if ("format" in input) {
+    /* LumImage */
+    const { data, width, height, rowStride = width } = input;
+    if (
+      rowStride < width ||
+      data.byteLength < rowStride * (height - 1) + width
+    ) {
+      throw new TypeError(
+        "Luma plane is smaller than width, height and rowStride imply",
+      );
+    }
+    // Only the Y plane is needed, the chroma planes never leave JS.
+    const buffer = data.subarray(
+      0,
+      Math.min(data.byteLength, rowStride * height),
+    );
+    return { type: "lum", buffer, width, height, rowStride };
+  }
+  if ("width" in input && "height" in input && "data" in input) {
+    /* ImageData */
+    const { data: buffer, width, height } = input;
+    return { type: "pixmap", buffer, width, height };
+  }
+  if ("buffer" in input) {
+    /* Uint8Array */
+    return { type: "image", buffer: input };
+  }
+  if ("byteLength" in input) {
+    /* ArrayBuffer */
+    return { type: "image", buffer: new Uint8Array(input) };
+  }
+  if ("size" in input) {
+    /* Blob */
+    return { type: "image", buffer: new Uint8Array(await input.arrayBuffer()) };
+  }
+  throw new TypeError("Invalid input type");
+}
+
+/**
+ * One read function per kind of resolved input, called with the input already copied into the heap.
+ */
+interface HeapReaders<R> {
+  pixmap(bufferPtr: number, width: number, height: number): R;
+  lum(bufferPtr: number, width: number, height: number, rowStride: number): R;
+  image(bufferPtr: number, bufferLength: number): R;
+}
+
+/**
+ * Copies a resolved input into the module heap, reads it and frees the copy again.
+ */
+function readFromHeap<R>(
+  ScanXModule: ScanXReaderModule,
+  resolvedInput: ResolvedReadInput,
+  readers: HeapReaders<R>,
+) {
+  const bufferPtr = ScanXModule._malloc(resolvedInput.buffer.byteLength);
+  ScanXModule.HEAPU8.set(resolvedInput.buffer, bufferPtr);
+  try {
+    switch (resolvedInput.type) {
+      case "pixmap":
+        return readers.pixmap(
+          bufferPtr,
+          resolvedInput.width,
+          resolvedInput.height,
+        );
+      case "lum":
+        return readers.lum(
+          bufferPtr,
+          resolvedInput.width,
+          resolvedInput.height,
+          resolvedInput.rowStride,
+        );
+      default:
+        return readers.image(bufferPtr, resolvedInput.buffer.byteLength);
+    }
+  } finally {
+    ScanXModule._free(bufferPtr);
+  }
+}
+
+/**
+ * The reader options that decide which metadata {@link withReadMetadata | `withReadMetadata`}
+ * attaches to the results.
+ */
+type ReadMetadataOptions = Pick<ScanXReaderOptions, "cascade" | "timeBudgetMs">;
+
+/**
+ * Attaches the stage timings of the last read of the module to its results, if it was profiled,
+ * the cascade tier that read it, if a cascade is configured, and whether it ran out of time, if a
+ * time budget is configured.
+ *
+ * @param start - When the read started, or `undefined` if profiling is disabled
+ * @param options - The reader options of the read
+ * @param convert - Converts the results of the module, timed as part of `marshalMs`
+ */
+function withReadMetadata<R extends ReadResult>(
+  ScanXModule: ScanXReaderModule,
+  start: number | undefined,
+  { cascade, timeBudgetMs }: ReadMetadataOptions,
+  convert: () => R[],
+): ProfiledReadResults<R> {
+  const convertStart = start === undefined ? 0 : performance.now();
+  const readResults: ProfiledReadResults<R> = convert();
+  if (cascade.length > 0) {
+    readResults.cascadeTier = ScanXModule.getCascadeTier();
+  }
+  if (timeBudgetMs > 0) {
+    readResults.budgetExceeded = ScanXModule.getBudgetExceeded();
+  }
+  if (start === undefined) return readResults;
+  const end = performance.now();
+  const profile = ScanXModule.getReadProfile();
+  readResults.profile = {
+    ...profile,
+    marshalMs: profile.marshalMs + end - convertStart,
+    totalMs: end - start,
+  };
+  return readResults;
+}
+
 /**
  * Reads barcodes from an image using a ScanX module factory.
  *
  * @param ScanXModuleFactory - Factory function to create a ScanX module instance
- * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, or ImageData
+ * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, ImageData, or LumImage
  * @param readerOptions - Optional configuration options for barcode reading (defaults to defaultReaderOptions)
  * @returns An array of ReadResult objects containing decoded barcode information
  *
@@ -315,61 +793,271 @@ export function purgeScanXModuleWithFactory<T extends ScanXModuleType>(
  */
 export async function readBarcodesWithFactory<T extends "reader" | "full">(
   ScanXModuleFactory: ScanXModuleFactory<T>,
-  input: Blob | ArrayBuffer | Uint8Array | ImageData,
+  input: ReadInput,
   readerOptions: ReaderOptions = defaultReaderOptions,
   cdnHost?: CDNHost,
 ) {
-  const requiredReaderOptions: Required<ReaderOptions> = {
+  const ScanXReaderOptions = readerOptionsToScanXReaderOptions({
     ...defaultReaderOptions,
     ...readerOptions,
-  };
+  });
   const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
     fireImmediately: true,
     cdnHost,
   });
-  let ScanXReadResultVector: ScanXVector<ScanXReadResult>;
-  let bufferPtr: number;
+  const start = ScanXReaderOptions.profile ? performance.now() : undefined;
+  const resolvedInput = await resolveReadInput(input);
+  const ScanXReadResultVector = readFromHeap(ScanXModule, resolvedInput, {
+    pixmap: (bufferPtr, width, height) =>
+      ScanXModule.readBarcodesFromPixmap(
+        bufferPtr,
+        width,
+        height,
+        ScanXReaderOptions,
+      ),
+    lum: (bufferPtr, width, height, rowStride) =>
+      ScanXModule.readBarcodesFromLuma(
+        bufferPtr,
+        width,
+        height,
+        rowStride,
+        ScanXReaderOptions,
+      ),
+    image: (bufferPtr, bufferLength) =>
+      ScanXModule.readBarcodesFromImage(
+        bufferPtr,
+        bufferLength,
+        ScanXReaderOptions,
+      ),
+  });
+  return withReadMetadata(ScanXModule, start, ScanXReaderOptions, () =>
+    ScanXReadResultVectorToReadResults(ScanXReadResultVector),
+  );
+}
 
-  if ("width" in input && "height" in input && "data" in input) {
-    /* ImageData */
-    const {
-      data: buffer,
-      data: { byteLength: size },
-      width,
-      height,
-    } = input;
-    bufferPtr = ScanXModule._malloc(size);
-    ScanXModule.HEAPU8.set(buffer, bufferPtr);
-    ScanXReadResultVector = ScanXModule.readBarcodesFromPixmap(
+/**
+ * Reads barcodes from an image using a ScanX module factory, returning packed results.
+ *
+ * @param ScanXModuleFactory - Factory function to create a ScanX module instance
+ * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, ImageData, or LumImage
+ * @param readerOptions - Optional configuration options for barcode reading (defaults to defaultReaderOptions)
+ * @param omitFields - Optional result fields that are not needed and should not be packed
+ * @returns An array of ReadResult objects whose fields are decoded on access
+ *
+ * @remarks
+ * All results are written into a single buffer inside the module and copied out of the heap
+ * at once, instead of being converted field by field.
+ */
+export async function readBarcodesPackedWithFactory<
+  T extends "reader" | "full",
+>(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  input: ReadInput,
+  readerOptions: ReaderOptions = defaultReaderOptions,
+  omitFields: PackedResultField[] = [],
+  cdnHost?: CDNHost,
+) {
+  const ScanXReaderOptions = readerOptionsToScanXReaderOptions({
+    ...defaultReaderOptions,
+    ...readerOptions,
+  });
+  const fields = encodePackedResultFields(omitFields);
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  const start = ScanXReaderOptions.profile ? performance.now() : undefined;
+  const resolvedInput = await resolveReadInput(input);
+  // The returned views point into the module heap, `slice` copies them out before the next read.
+  const packedReadResults = readFromHeap(ScanXModule, resolvedInput, {
+    pixmap: (bufferPtr, width, height) =>
+      ScanXModule.readBarcodesFromPixmapPacked(
+        bufferPtr,
+        width,
+        height,
+        ScanXReaderOptions,
+        fields,
+      ).slice(),
+    lum: (bufferPtr, width, height, rowStride) =>
+      ScanXModule.readBarcodesFromLumaPacked(
+        bufferPtr,
+        width,
+        height,
+        rowStride,
+        ScanXReaderOptions,
+        fields,
+      ).slice(),
+    image: (bufferPtr, bufferLength) =>
+      ScanXModule.readBarcodesFromImagePacked(
+        bufferPtr,
+        bufferLength,
+        ScanXReaderOptions,
+        fields,
+      ).slice(),
+  });
+  return withReadMetadata(ScanXModule, start, ScanXReaderOptions, () =>
+    unpackReadResults(packedReadResults),
+  );
+}
+
+/**
+ * Encoded images (PNG, JPEG, ...) accepted by
+ * {@link readBarcodesFromImagesWithFactory | `readBarcodesFromImagesWithFactory`}.
+ */
+export type EncodedImage = Blob | ArrayBuffer | Uint8Array;
+
+/**
+ * Reads barcodes from many encoded images in a single call into a ScanX module.
+ *
+ * @param ScanXModuleFactory - Factory function to create a ScanX module instance
+ * @param inputs - Encoded images as Blobs, ArrayBuffers or Uint8Arrays
+ * @param readerOptions - Optional configuration options for barcode reading (defaults to defaultReaderOptions)
+ * @param omitFields - Optional result fields that are not needed and should not be packed
+ * @returns One array of ReadResult objects per input, in the order of the inputs
+ *
+ * @remarks
+ * All images are copied into the heap at once, the reader options are converted and the access
+ * token is checked only once, and the decoder reuses its scratch memory from image to image.
+ * An image that fails to decode or read only gets an error entry in its own results.
+ */
+export async function readBarcodesFromImagesWithFactory<
+  T extends "reader" | "full",
+>(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  inputs: EncodedImage[],
+  readerOptions: ReaderOptions = defaultReaderOptions,
+  omitFields: PackedResultField[] = [],
+  cdnHost?: CDNHost,
+) {
+  const ScanXReaderOptions = readerOptionsToScanXReaderOptions({
+    ...defaultReaderOptions,
+    ...readerOptions,
+  });
+  const fields = encodePackedResultFields(omitFields);
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  const buffers = await Promise.all(
+    inputs.map(async (input) => {
+      const resolvedInput = await resolveReadInput(input);
+      if (resolvedInput.type !== "image") {
+        throw new TypeError("Invalid input type");
+      }
+      return resolvedInput.buffer;
+    }),
+  );
+  const offsets = new Int32Array(buffers.length + 1);
+  for (let i = 0; i < buffers.length; ++i) {
+    offsets[i + 1] = offsets[i] + buffers[i].byteLength;
+  }
+  const bufferPtr = ScanXModule._malloc(Math.max(offsets[buffers.length], 1));
+  const offsetsPtr = ScanXModule._malloc(offsets.byteLength);
+  try {
+    buffers.forEach((buffer, i) => {
+      ScanXModule.HEAPU8.set(buffer, bufferPtr + offsets[i]);
+    });
+    ScanXModule.HEAPU8.set(new Uint8Array(offsets.buffer), offsetsPtr);
+    // The returned view points into the module heap, `slice` copies it out before the next batch.
+    const packedReadResults = ScanXModule.readBarcodesFromImages(
       bufferPtr,
-      width,
-      height,
-      readerOptionsToScanXReaderOptions(requiredReaderOptions),
+      offsetsPtr,
+      buffers.length,
+      ScanXReaderOptions,
+      fields,
+    ).slice();
+    return unpackBatchReadResults(
+      packedReadResults,
+      ScanXReaderOptions.cascade.length > 0,
+      ScanXReaderOptions.timeBudgetMs > 0,
     );
-  } else {
-    let size: number;
-    let buffer: Uint8Array;
-    if ("buffer" in input) {
-      /* Uint8Array */
-      [size, buffer] = [input.byteLength, input];
-    } else if ("byteLength" in input) {
-      /* ArrayBuffer */
-      [size, buffer] = [input.byteLength, new Uint8Array(input)];
-    } else if ("size" in input) {
-      /* Blob */
-      [size, buffer] = [input.size, new Uint8Array(await input.arrayBuffer())];
-    } else {
-      throw new TypeError("Invalid input type");
-    }
-    bufferPtr = ScanXModule._malloc(size);
+  } finally {
+    ScanXModule._free(isTextPtr);
+    ScanXModule._free(offsetsPtr);
+    ScanXModule._free(bufferPtr);
+  }
+}
+
+/**
+ * Options of {@link readBarcodesFromFramesWithFactory | `readBarcodesFromFramesWithFactory`}.
+ */
+export interface ReadFramesOptions {
+  /**
+   * Stop at the first frame that yields a valid barcode. Only the results of the frames up to and
+   * including it are returned.
+   *
+   * @defaultValue `false`
+   */
+  stopAtFirstCode?: boolean;
+  /**
+   * Result fields that are not needed and should not be packed.
+   *
+   * @defaultValue `[]`
+   */
+  omitFields?: PackedResultField[];
+}
+
+/**
+ * Reads barcodes from every frame of an animated GIF in a single call into a ScanX module.
+ *
+ * @param ScanXModuleFactory - Factory function to create a ScanX module instance
+ * @param input - The encoded image as a Blob, ArrayBuffer or Uint8Array
+ * @param readerOptions - Optional configuration options for barcode reading (defaults to defaultReaderOptions)
+ * @param readFramesOptions - Optional early stop and fields to leave out
+ * @returns One array of ReadResult objects per frame, in frame order
+ *
+ * @remarks
+ * The image is copied into the heap and every frame is decoded in one go, then the frames are read in
+ * turn out of the same buffer. Images of other formats are read as a single frame. If the image fails
+ * to decode, the only entry holds the error.
+ */
+export async function readBarcodesFromFramesWithFactory<
+  T extends "reader" | "full",
+>(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  input: EncodedImage,
+  readerOptions: ReaderOptions = defaultReaderOptions,
+  { stopAtFirstCode = false, omitFields = [] }: ReadFramesOptions = {},
+  cdnHost?: CDNHost,
+) {
+  const ScanXReaderOptions = readerOptionsToScanXReaderOptions({
+    ...defaultReaderOptions,
+    ...readerOptions,
+  });
+  const fields = encodePackedResultFields(omitFields);
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  const resolvedInput = await resolveReadInput(input);
+  if (resolvedInput.type !== "image") {
+    throw new TypeError("Invalid input type");
+  }
+  const { buffer } = resolvedInput;
+  const bufferPtr = ScanXModule._malloc(Math.max(buffer.byteLength, 1));
+  try {
     ScanXModule.HEAPU8.set(buffer, bufferPtr);
-    ScanXReadResultVector = ScanXModule.readBarcodesFromImage(
+    // The returned view points into the module heap, `slice` copies it out before the next call.
+    const packedReadResults = ScanXModule.readBarcodesFromFrames(
       bufferPtr,
-      size,
-      readerOptionsToScanXReaderOptions(requiredReaderOptions),
+      buffer.byteLength,
+      ScanXReaderOptions,
+      fields,
+      stopAtFirstCode,
+    ).slice();
+    return unpackBatchReadResults(
+      packedReadResults,
+      ScanXReaderOptions.cascade.length > 0,
+      ScanXReaderOptions.timeBudgetMs > 0,
     );
+  } finally {
+    ScanXModule._free(bufferPtr);
   }
-  ScanXModule._free(bufferPtr);
+}
+
+function ScanXReadResultVectorToReadResults(
+  ScanXReadResultVector: ScanXVector<ScanXReadResult>,
+) {
   const readResults: ReadResult[] = [];
   for (let i = 0; i < ScanXReadResultVector.size(); ++i) {
     readResults.push(
@@ -383,7 +1071,7 @@ export async function readBarcodesWithFactory<T extends "reader" | "full">(
  * Reads a single barcode from an image using a ScanX module factory.
  *
  * @param ScanXModuleFactory - Factory function to create a ScanX module instance
- * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, or ImageData
+ * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, ImageData, or LumImage
  * @param readerOptions - Optional configuration options for barcode reading (defaults to defaultReaderOptions)
  * @returns A single ReadResult object containing decoded barcode information or null if no barcode is found
  *
@@ -393,7 +1081,7 @@ export async function readBarcodesWithFactory<T extends "reader" | "full">(
  */
 export async function readSingleBarcodeWithFactory<T extends "reader" | "full">(
   ScanXModuleFactory: ScanXModuleFactory<T>,
-  input: Blob | ArrayBuffer | Uint8Array | ImageData,
+  input: ReadInput,
   readerOptions: Omit<
     ReaderOptions,
     "maxNumberOfSymbols"
@@ -411,78 +1099,332 @@ export async function readSingleBarcodeWithFactory<T extends "reader" | "full">(
     cdnHost,
   });
 
+  const resolvedInput = await resolveReadInput(input);
+  const bufferPtr = ScanXModule._malloc(resolvedInput.buffer.byteLength);
+  ScanXModule.HEAPU8.set(resolvedInput.buffer, bufferPtr);
+
   let result: ScanXReadResult | null = null;
-  let bufferPtr = 0; // Initialize to 0 to indicate "not allocated yet"
 
   try {
-    if ("width" in input && "height" in input && "data" in input) {
-      /* ImageData */
-      const {
-        data: buffer,
-        data: { byteLength: size },
-        width,
-        height,
-      } = input;
-      bufferPtr = ScanXModule._malloc(size);
-      ScanXModule.HEAPU8.set(buffer, bufferPtr);
-
+    if (resolvedInput.type === "pixmap") {
       result = ScanXModule.readSingleBarcodeFromPixmap(
         bufferPtr,
-        width,
-        height,
+        resolvedInput.width,
+        resolvedInput.height,
         readerOptionsToScanXReaderOptions(requiredReaderOptions),
       );
     } else {
-      let size: number;
-      let buffer: Uint8Array;
-
-      if ("buffer" in input) {
-        /* Uint8Array */
-        [size, buffer] = [input.byteLength, input];
-      } else if ("byteLength" in input) {
-        /* ArrayBuffer */
-        [size, buffer] = [input.byteLength, new Uint8Array(input)];
-      } else if ("size" in input) {
-        /* Blob */
-        [size, buffer] = [
-          input.size,
-          new Uint8Array(await input.arrayBuffer()),
-        ];
-      } else {
-        throw new TypeError("Invalid input type");
-      }
+      const results =
+        resolvedInput.type === "lum"
+          ? ScanXModule.readBarcodesFromLuma(
+              bufferPtr,
+              resolvedInput.width,
+              resolvedInput.height,
+              resolvedInput.rowStride,
+              readerOptionsToScanXReaderOptions(requiredReaderOptions),
+            )
+          : ScanXModule.readBarcodesFromImage(
+              bufferPtr,
+              resolvedInput.buffer.byteLength,
+              readerOptionsToScanXReaderOptions(requiredReaderOptions),
+            );
+      result = results.size() > 0 ? (results.get(0) ?? null) : null;
+    }
+  } finally {
+    // Ensure memory is freed even if an error occurs
+    ScanXModule._free(bufferPtr);
+  }
 
-      bufferPtr = ScanXModule._malloc(size);
-      ScanXModule.HEAPU8.set(buffer, bufferPtr);
+  // Convert result if found
+  return result ? ScanXReadResultToReadResult(result) : null;
+}
 
-      const results = ScanXModule.readBarcodesFromImage(
-        bufferPtr,
-        size,
-        readerOptionsToScanXReaderOptions(requiredReaderOptions),
-      );
+/**
+ * A read result of a {@link ScannerSession | `ScannerSession`}.
+ */
+export type SessionReadResult = ReadResult & {
+  /**
+   * ID of the barcode's track while tracking is enabled, see
+   * {@link ScannerSession.setTracking | `setTracking`}. A barcode that stays
+   * in view keeps its ID from frame to frame.
+   */
+  trackId?: number;
+};
 
-      if (results.size() > 0) {
-        const firstResult = results.get(0);
-        if (firstResult !== undefined) {
-          result = firstResult;
-        }
-      }
+/**
+ * Counters of the change detection of a {@link ScannerSession | `ScannerSession`}, see
+ * {@link ScannerSession.setChangeDetection | `setChangeDetection`}.
+ */
+export interface ChangeDetectionStats {
+  /**
+   * Number of frames compared since change detection was last configured.
+   */
+  frames: number;
+  /**
+   * Number of those frames that were not read because they were unchanged.
+   */
+  skipped: number;
+}
+
+/**
+ * A persistent barcode reader bound to a single module instance.
+ *
+ * @remarks
+ * The session owns a grow-only input buffer inside the WASM heap together with the converted
+ * reader options and the result storage, so repeatedly scanning same-sized frames (e.g. from a
+ * camera stream) does not allocate or free heap memory per call.
+ * Call {@link ScannerSession.dispose | `dispose`} to release the native session once done.
+ */
+export class ScannerSession {
+  #ScanXModule: ScanXReaderModule;
+  #session: ScanXReaderSession | null;
+  #profile: boolean;
+  #readMetadataOptions: ReadMetadataOptions;
+  #changeDetection = false;
+
+  /**
+   * @internal
+   */
+  constructor(ScanXModule: ScanXReaderModule, readerOptions?: ReaderOptions) {
+    const ScanXReaderOptions = readerOptionsToScanXReaderOptions({
+      ...defaultReaderOptions,
+      ...readerOptions,
+    });
+    this.#ScanXModule = ScanXModule;
+    this.#session = new ScanXModule.ReaderSession(ScanXReaderOptions);
+    this.#profile = ScanXReaderOptions.profile;
+    this.#readMetadataOptions = ScanXReaderOptions;
+  }
+
+  #getSession() {
+    if (!this.#session) {
+      throw new Error("ScannerSession has been disposed");
     }
+    return this.#session;
+  }
+
+  /**
+   * Replaces the reader options used by subsequent reads.
+   *
+   * @param readerOptions - Reader options, missing values fall back to the defaults
+   */
+  setReaderOptions(readerOptions?: ReaderOptions) {
+    const ScanXReaderOptions = readerOptionsToScanXReaderOptions({
+      ...defaultReaderOptions,
+      ...readerOptions,
+    });
+    this.#getSession().setOptions(ScanXReaderOptions);
+    this.#profile = ScanXReaderOptions.profile;
+    this.#readMetadataOptions = ScanXReaderOptions;
+  }
+
+  /**
+   * Enables or disables tracking mode for video frames.
+   *
+   * While tracking, only windows around the barcodes of the previous frame are read.
+   * A full frame scan runs whenever one of them is missed and every `fullScanInterval` frames,
+   * so barcodes entering the view are still found. Results carry a stable `trackId`, which lets
+   * the app handle every barcode once instead of once per frame.
+   *
+   * @param fullScanInterval - Scan the full frame at least every this many frames, `0` turns tracking off
+   */
+  setTracking(fullScanInterval: number) {
+    this.#getSession().setTracking(fullScanInterval);
+  }
 
-    // Clean up allocated memory
-    if (bufferPtr) {
-      ScanXModule._free(bufferPtr);
+  /**
+   * Enables or disables change detection for video frames.
+   *
+   * Every frame is reduced to a 16x16 grid of block means of its luma and compared with the last
+   * frame that was actually read. When they differ by less than `threshold` luma levels on average,
+   * the frame is not read and the results of that frame are returned again, flagged `unchanged`.
+   * This saves most of the work on a steady camera, at the cost of missing changes too small to show
+   * in the grid, so keep `threshold` low (e.g. `2`-`4`). A read cut short by
+   * {@link ReaderOptions.timeBudgetMs | `timeBudgetMs`} is never reused. Skipped frames are left out
+   * of the reader stats.
+   *
+   * @param threshold - Mean absolute difference in luma levels (0-255) below which a frame is unchanged, `0` turns change detection off
+   */
+  setChangeDetection(threshold: number) {
+    this.#getSession().setChangeDetection(threshold);
+    this.#changeDetection = threshold > 0;
+  }
+
+  /**
+   * Returns how many frames change detection compared and how many of them it skipped.
+   */
+  getChangeDetectionStats(): ChangeDetectionStats {
+    return this.#getSession().changeDetectionStats();
+  }
+
+  /**
+   * Attaches the track IDs of the last read to its results, if tracking is enabled, and whether
+   * its frame was unchanged, if change detection is enabled.
+   */
+  #withSessionMetadata<R extends ProfiledReadResults<SessionReadResult>>(
+    readResults: R,
+  ) {
+    const session = this.#getSession();
+    const trackIds = session.trackIds();
+    if (trackIds.length === readResults.length) {
+      readResults.forEach((readResult, i) => {
+        readResult.trackId = trackIds[i];
+      });
+    }
+    if (this.#changeDetection) {
+      readResults.unchanged = session.frameUnchanged();
     }
+    return readResults;
+  }
 
-    // Convert result if found
-    return result ? ScanXReadResultToReadResult(result) : null;
-  } catch (error) {
-    // Ensure memory is freed even if an error occurs
-    if (bufferPtr) {
-      ScanXModule._free(bufferPtr);
+  /**
+   * Copies the input into the session's input buffer and reads it with one of `readers`.
+   */
+  async #read<R>(
+    input: ReadInput,
+    readers: (session: ScanXReaderSession) => HeapReaders<R>,
+  ) {
+    const resolvedInput = await resolveReadInput(input);
+    const session = this.#getSession();
+    // `inputBuffer` may grow the heap, so `HEAPU8` must be read afterwards.
+    const bufferPtr = session.inputBuffer(resolvedInput.buffer.byteLength);
+    this.#ScanXModule.HEAPU8.set(resolvedInput.buffer, bufferPtr);
+    const { pixmap, lum, image } = readers(session);
+    switch (resolvedInput.type) {
+      case "pixmap":
+        return pixmap(bufferPtr, resolvedInput.width, resolvedInput.height);
+      case "lum":
+        return lum(
+          bufferPtr,
+          resolvedInput.width,
+          resolvedInput.height,
+          resolvedInput.rowStride,
+        );
+      default:
+        return image(bufferPtr, resolvedInput.buffer.byteLength);
     }
-    throw error;
   }
+
+  /**
+   * Reads barcodes from an image, reusing the session's input buffer.
+   *
+   * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, ImageData, or LumImage
+   * @returns An array of ReadResult objects containing decoded barcode information,
+   * with a `trackId` while tracking is enabled
+   */
+  async readBarcodes(input: ReadInput) {
+    const start = this.#profile ? performance.now() : undefined;
+    const ScanXReadResultVector = await this.#read(input, (session) => ({
+      pixmap: (_, width, height) =>
+        session.readBarcodesFromPixmap(width, height),
+      lum: (_, width, height, rowStride) =>
+        session.readBarcodesFromLuma(width, height, rowStride),
+      image: (_, bufferLength) => session.readBarcodesFromImage(bufferLength),
+    }));
+    return this.#withSessionMetadata(
+      withReadMetadata(
+        this.#ScanXModule,
+        start,
+        this.#readMetadataOptions,
+        () => ScanXReadResultVectorToReadResults(ScanXReadResultVector),
+      ),
+    );
+  }
+
+  /**
+   * Reads barcodes from an image, reusing the session's input buffer and returning packed results.
+   *
+   * @param input - Source image data as a Blob, ArrayBuffer, Uint8Array, ImageData, or LumImage
+   * @param omitFields - Optional result fields that are not needed and should not be packed
+   * @returns An array of ReadResult objects whose fields are decoded on access
+   */
+  async readBarcodesPacked(
+    input: ReadInput,
+    omitFields: PackedResultField[] = [],
+  ) {
+    const fields = encodePackedResultFields(omitFields);
+    const start = this.#profile ? performance.now() : undefined;
+    const packedReadResults = await this.#read(input, (session) => ({
+      pixmap: (_, width, height) =>
+        session.readBarcodesFromPixmapPacked(width, height, fields).slice(),
+      lum: (_, width, height, rowStride) =>
+        session
+          .readBarcodesFromLumaPacked(width, height, rowStride, fields)
+          .slice(),
+      image: (_, bufferLength) =>
+        session.readBarcodesFromImagePacked(bufferLength, fields).slice(),
+    }));
+    return this.#withSessionMetadata(
+      withReadMetadata(
+        this.#ScanXModule,
+        start,
+        this.#readMetadataOptions,
+        () => unpackReadResults(packedReadResults),
+      ),
+    );
+  }
+
+  /**
+   * Releases the native session. The session can't be used afterwards.
+   */
+  dispose() {
+    this.#session?.delete();
+    this.#session = null;
+  }
+}
+
+/**
+ * Creates a {@link ScannerSession | `ScannerSession`} using a ScanX module factory.
+ *
+ * @param ScanXModuleFactory - Factory function to create a ScanX module instance
+ * @param readerOptions - Optional configuration options for barcode reading (defaults to defaultReaderOptions)
+ * @returns A promise that resolves to the scanner session
+ */
+export async function createScannerSessionWithFactory<
+  T extends "reader" | "full",
+>(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  readerOptions?: ReaderOptions,
+  cdnHost?: CDNHost,
+) {
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  return new ScannerSession(ScanXModule, readerOptions);
+}
+
+/**
+ * Returns the cumulative reader stats of the module instance of a ScanX module factory.
+ *
+ * @param ScanXModuleFactory - Factory function to create a ScanX module instance
+ * @returns Counters over every read since the module was instantiated or the stats were reset
+ */
+export async function getReaderStatsWithFactory<T extends "reader" | "full">(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  cdnHost?: CDNHost,
+) {
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  return ScanXReaderStatsToReaderStats(ScanXModule.getReaderStats());
+}
+
+/**
+ * Resets the cumulative reader stats of the module instance of a ScanX module factory.
+ *
+ * @param ScanXModuleFactory - Factory function to create a ScanX module instance
+ */
+export async function resetReaderStatsWithFactory<T extends "reader" | "full">(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  cdnHost?: CDNHost,
+) {
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  ScanXModule.resetReaderStats();
 }
 
 /**
@@ -531,6 +1473,126 @@ export async function writeBarcodeWithFactory<T extends "writer" | "full">(
   return ScanXWriteResultToWriteResult(ScanXWriteResult);
 }
 
+/**
+ * Returns the counters of the cache of generated barcodes of a ScanX module factory.
+ *
+ * @param ScanXModuleFactory - The factory function that creates a ScanX module instance
+ * @returns Hits and misses since the cache was created or last purged, and its current size
+ */
+export async function getWriteCacheStatsWithFactory<
+  T extends "writer" | "full",
+>(ScanXModuleFactory: ScanXModuleFactory<T>, cdnHost?: CDNHost) {
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  return ScanXModule.getWriteCacheStats();
+}
+
+/**
+ * Sets the capacity of the cache of generated barcodes of a ScanX module factory.
+ *
+ * @param ScanXModuleFactory - The factory function that creates a ScanX module instance
+ * @param capacity - Bytes the cached outputs may take, `0` turns the cache off
+ *
+ * @remarks
+ * Writes are cached by payload and writer options, least recently used first out. A barcode
+ * written again with the same options is returned without being created, rendered or encoded
+ * again. The cache holds 4 MiB by default, lowering the capacity evicts what no longer fits.
+ */
+export async function setWriteCacheCapacityWithFactory<
+  T extends "writer" | "full",
+>(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  capacity: number,
+  cdnHost?: CDNHost,
+) {
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  ScanXModule.setWriteCacheCapacity(capacity);
+}
+
+/**
+ * Drops every barcode cached by the module instance of a ScanX module factory and resets the
+ * counters. Unlike {@link purgeScanXModuleWithFactory | `purgeScanXModuleWithFactory`}, which
+ * also does this, the instance is kept. Does nothing if the module was never instantiated.
+ *
+ * @param ScanXModuleFactory - The factory function that creates a ScanX module instance
+ */
+export async function purgeWriteCacheWithFactory<T extends "writer" | "full">(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+) {
+  const ScanXModule = await __CACHE__.get(ScanXModuleFactory)?.[1];
+  if (ScanXModule && "purgeWriteCache" in ScanXModule) {
+    ScanXModule.purgeWriteCache();
+  }
+}
+
+/**
+ * Generates many barcodes with the same writer options in a single call into a ScanX module.
+ *
+ * @param ScanXModuleFactory - The factory function that creates a ScanX module instance
+ * @param inputs - The data to encode, strings and Uint8Arrays may be mixed
+ * @param writerOptions - Optional configuration options shared by all barcodes
+ * @returns A promise that resolves to one write result per input, in the same order
+ *
+ * @remarks
+ * All payloads are copied into the heap at once and the writer options are converted only once.
+ * The outputs of all barcodes come back in one packed buffer, and each result converts its
+ * outputs lazily on access. A failing input only sets the `error` of its own result.
+ */
+export async function writeBarcodesWithFactory<T extends "writer" | "full">(
+  ScanXModuleFactory: ScanXModuleFactory<T>,
+  inputs: (string | Uint8Array)[],
+  writerOptions: WriterOptions = defaultWriterOptions,
+  cdnHost?: CDNHost,
+) {
+  const ScanXWriterOptions = writerOptionsToScanXWriterOptions({
+    ...defaultWriterOptions,
+    ...writerOptions,
+  });
+  const ScanXModule = await prepareScanXModuleWithFactory(ScanXModuleFactory, {
+    fireImmediately: true,
+    cdnHost,
+  });
+  // Text and binary payloads may be mixed, every entry is flagged with its own kind.
+  const encoder = new TextEncoder();
+  const isText = Uint8Array.from(inputs, (input) =>
+    typeof input === "string" ? 1 : 0,
+  );
+  const payloads = inputs.map((input) =>
+    typeof input === "string" ? encoder.encode(input) : input,
+  );
+  const offsets = new Int32Array(payloads.length + 1);
+  for (let i = 0; i < payloads.length; ++i) {
+    offsets[i + 1] = offsets[i] + payloads[i].byteLength;
+  }
+  const bufferPtr = ScanXModule._malloc(Math.max(offsets[payloads.length], 1));
+  const offsetsPtr = ScanXModule._malloc(offsets.byteLength);
+  const isTextPtr = ScanXModule._malloc(Math.max(isText.byteLength, 1));
+  try {
+    payloads.forEach((payload, i) => {
+      ScanXModule.HEAPU8.set(payload, bufferPtr + offsets[i]);
+    });
+    ScanXModule.HEAPU8.set(new Uint8Array(offsets.buffer), offsetsPtr);
+    ScanXModule.HEAPU8.set(isText, isTextPtr);
+    // The returned view points into the module heap, `slice` copies it out before the next batch.
+    const packedWriteResults = ScanXModule.writeBarcodesFromPayloads(
+      bufferPtr,
+      offsetsPtr,
+      isTextPtr,
+      payloads.length,
+      ScanXWriterOptions,
+    ).slice();
+    return unpackWriteResults(packedWriteResults);
+  } finally {
+    ScanXModule._free(offsetsPtr);
+    ScanXModule._free(bufferPtr);
+  }
+}
+
 if (import.meta.env.MODE === "miniprogram") {
   /* A bare minimum Blob polyfill */
   globalThis.Blob ??= class {
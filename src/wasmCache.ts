@@ -0,0 +1,162 @@
+/// <reference types="node" />
+
+/**
+ * Name of the Cache API cache / on-disk directory for the `.wasm` files of this release.
+ * Both change with the package version and the ZXing commit, so a new release never reads
+ * the binaries of an older one.
+ */
+const CACHE_NAME = `scanx-wasm@${NPM_PACKAGE_VERSION}-${SUBMODULE_COMMIT}`;
+
+const CACHE_NAME_PREFIX = "scanx-wasm@";
+
+/**
+ * Compiled modules by `.wasm` URL, shared by every instantiation in this realm.
+ */
+const compiledModules = new Map<string, Promise<WebAssembly.Module>>();
+
+export function isNode() {
+  return (
+    typeof process !== "undefined" && typeof process.versions?.node === "string"
+  );
+}
+
+/**
+ * Compiles a `.wasm` response, streaming it if the engine and the response allow for it.
+ */
+async function compileResponse(response: Response) {
+  if (
+    typeof WebAssembly.compileStreaming === "function" &&
+    response.headers.get("Content-Type") === "application/wasm"
+  ) {
+    return WebAssembly.compileStreaming(response);
+  }
+  return WebAssembly.compile(await response.arrayBuffer());
+}
+
+async function fetchWasm(url: string) {
+  const response = await fetch(url, { credentials: "same-origin" });
+  if (!response.ok) {
+    throw new Error(`Failed to fetch ${url}: ${response.status}`);
+  }
+  return response;
+}
+
+let staleCachesDeleted: Promise<unknown> | undefined;
+
+/**
+ * Opens the Cache API cache of this release and, once per realm, deletes those of other releases.
+ * Resolves to `undefined` where the Cache API is missing or denied (e.g. opaque origins).
+ */
+async function openCache() {
+  if (typeof caches === "undefined") return undefined;
+  try {
+    staleCachesDeleted ??= caches.keys().then((names) =>
+      Promise.all(
+        names
+          .filter(
+            (name) => name.startsWith(CACHE_NAME_PREFIX) && name !== CACHE_NAME,
+          )
+          .map((name) => caches.delete(name)),
+      ),
+    );
+    await staleCachesDeleted;
+    return await caches.open(CACHE_NAME);
+  } catch {
+    return undefined;
+  }
+}
+
+/**
+ * Browsers: serves the `.wasm` response from the Cache API, so it is neither downloaded again nor,
+ * in engines that keep compiled code for cached responses (V8), recompiled from scratch.
+ */
+async function compileFromCacheStorage(url: string) {
+  const cache = await openCache();
+  const cachedResponse = await cache?.match(url);
+  if (cachedResponse) return compileResponse(cachedResponse);
+  const response = await fetchWasm(url);
+  await cache?.put(url, response.clone()).catch(() => {});
+  return compileResponse(response);
+}
+
+/**
+ * Node.js: keeps downloaded `.wasm` files on disk with `persist`, so a cold process start reads them
+ * from there instead of the network. Local paths and `file:` URLs are always read in place.
+ */
+async function compileFromDisk(url: string, persist: WasmCacheOptions | false) {
+  const { randomUUID } = await import("node:crypto");
+  const { mkdir, readFile, rename, unlink, writeFile } = await import(
+    "node:fs/promises"
+  );
+  const { tmpdir } = await import("node:os");
+  const { basename, join } = await import("node:path");
+  const { fileURLToPath } = await import("node:url");
+  const { threadId } = await import("node:worker_threads");
+
+  if (!/^https?:/.test(url)) {
+    return WebAssembly.compile(
+      await readFile(url.startsWith("file:") ? fileURLToPath(url) : url),
+    );
+  }
+
+  if (!persist) return compileResponse(await fetchWasm(url));
+
+  const cacheDirectory = join(
+    persist.directory ?? join(tmpdir(), "scanx-wasm"),
+    CACHE_NAME,
+  );
+  const path = join(cacheDirectory, basename(new URL(url).pathname));
+  let bytes: Uint8Array;
+  try {
+    bytes = await readFile(path);
+  } catch {
+    bytes = new Uint8Array(await (await fetchWasm(url)).arrayBuffer());
+    // Written next to the target and renamed, so concurrent processes and worker threads never
+    // read a partial file. Pool workers share the pid of their process, so the name can't rely on it.
+    const partialPath = `${path}.${threadId}-${randomUUID()}.partial`;
+    await mkdir(cacheDirectory, { recursive: true })
+      .then(() => writeFile(partialPath, bytes))
+      .then(() => rename(partialPath, path))
+      .catch(() => unlink(partialPath).catch(() => {}));
+  }
+  return WebAssembly.compile(bytes);
+}
+
+/**
+ * Options of the compiled module cache.
+ */
+export interface WasmCacheOptions {
+  /**
+   * Directory for the downloaded `.wasm` files on Node.js.
+   *
+   * @defaultValue `path.join(os.tmpdir(), "scanx-wasm")`
+   */
+  directory?: string;
+}
+
+/**
+ * Compiles the `.wasm` file at `url` once per realm. With `persist`, the file is also kept in the
+ * Cache API (browsers) or on disk (Node.js) across page loads and process starts.
+ *
+ * @param url - The URL returned by `locateFile`
+ * @param persist - Whether to keep the file across page loads / process starts, and where
+ * @returns The compiled module, a failed compilation is not cached
+ */
+export function compileWasm(
+  url: string,
+  persist: WasmCacheOptions | false,
+): Promise<WebAssembly.Module> {
+  let compiledModule = compiledModules.get(url);
+  if (!compiledModule) {
+    if (isNode()) {
+      compiledModule = compileFromDisk(url, persist);
+    } else if (persist) {
+      compiledModule = compileFromCacheStorage(url);
+    } else {
+      compiledModule = fetchWasm(url).then(compileResponse);
+    }
+    compiledModules.set(url, compiledModule);
+    compiledModule.catch(() => compiledModules.delete(url));
+  }
+  return compiledModule;
+}
@@ -9,15 +9,24 @@ import type { Merge } from "type-fest";
 import type { WriterOptions } from "../bindings/index.js";
 import {
   type CDNHost,
+  getWriteCacheStatsWithFactory,
   type PrepareScanXModuleOptions,
   prepareScanXModuleWithFactory,
+  prewarmScanXModuleWithFactory,
   purgeScanXModuleWithFactory,
+  purgeWriteCacheWithFactory,
+  registerWasmFile,
+  resolveWasmHash,
   type ScanXModuleOverrides,
   type ScanXWriterModule,
+  setWriteCacheCapacityWithFactory,
+  writeBarcodesWithFactory,
   writeBarcodeWithFactory,
 } from "../share.js";
 import ScanXModuleFactory from "./scanx_writer.js";
 
+registerWasmFile(ScanXModuleFactory, "scanx_writer.wasm");
+
 export function prepareScanXModule(
   options?: Merge<PrepareScanXModuleOptions, { fireImmediately?: false }>,
 ): void;
@@ -34,6 +43,17 @@ export function prepareScanXModule(options?: PrepareScanXModuleOptions) {
   return prepareScanXModuleWithFactory(ScanXModuleFactory, options);
 }
 
+/**
+ * Downloads and compiles the module ahead of the first read or write, without instantiating it.
+ * Later instantiations reuse the compiled module, see
+ * {@link PrepareScanXModuleOptions.wasmCache | `wasmCache`}.
+ */
+export function prewarmScanXModule(
+  options?: Omit<PrepareScanXModuleOptions, "fireImmediately">,
+) {
+  return prewarmScanXModuleWithFactory(ScanXModuleFactory, options);
+}
+
 export function purgeScanXModule() {
   return purgeScanXModuleWithFactory(ScanXModuleFactory);
 }
@@ -93,6 +113,58 @@ export async function writeBarcode(
   );
 }
 
+/**
+ * Generates one barcode per input like {@link writeBarcode | `writeBarcode`}, but in a single
+ * call into the module with the writer options converted only once.
+ * Results are returned in input order, a failing input only sets the `error` of its own result.
+ * Batches bypass the cache of {@link setWriteCacheCapacity | `setWriteCacheCapacity`}.
+ */
+export async function writeBarcodes(
+  inputs: (string | Uint8Array)[],
+  writerOptions?: WriterOptions,
+  cdnHost?: CDNHost,
+) {
+  return writeBarcodesWithFactory(
+    ScanXModuleFactory,
+    inputs,
+    writerOptions,
+    cdnHost,
+  );
+}
+
+/**
+ * Returns the counters of the cache of generated barcodes, see
+ * {@link setWriteCacheCapacity | `setWriteCacheCapacity`}.
+ */
+export async function getWriteCacheStats(cdnHost?: CDNHost) {
+  return getWriteCacheStatsWithFactory(ScanXModuleFactory, cdnHost);
+}
+
+/**
+ * Sets how many bytes of generated barcodes the module keeps, `0` turns the cache off.
+ * A payload written again by {@link writeBarcode | `writeBarcode`} with the same writer options is
+ * returned from the cache without being created, rendered or encoded again. The least recently used barcodes are evicted first.
+ * The cache holds 4 MiB by default.
+ */
+export async function setWriteCacheCapacity(
+  capacity: number,
+  cdnHost?: CDNHost,
+) {
+  return setWriteCacheCapacityWithFactory(
+    ScanXModuleFactory,
+    capacity,
+    cdnHost,
+  );
+}
+
+/**
+ * Drops every cached barcode and resets the counters, without purging the module itself.
+ * {@link purgeScanXModule | `purgeScanXModule`} drops them as well.
+ */
+export async function purgeWriteCache() {
+  return purgeWriteCacheWithFactory(ScanXModuleFactory);
+}
+
 export * from "../bindings/exposedWriterBindings.js";
 export {
   type PrepareScanXModuleOptions,
@@ -100,5 +172,6 @@ export {
   SCANX_WASM_VERSION,
   type ScanXModuleOverrides,
   type ScanXWriterModule,
+  type WasmCacheOptions,
 } from "../share.js";
-export const SCANX_WASM_SHA256 = WRITER_HASH;
+export const SCANX_WASM_SHA256 = resolveWasmHash(WRITER_HASH, WRITER_SIMD_HASH);
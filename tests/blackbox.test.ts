@@ -22,6 +22,7 @@ import {
   parseExpectedBinary,
   parseExpectedResult,
   parseExpectedText,
+  READER_WASM,
   takeSnapshot,
   warmUpCache,
 } from "./utils.js";
@@ -76,7 +77,7 @@ await prepareScanXModule({
   overrides: {
     wasmBinary: (
       await readFile(
-        resolve(import.meta.dirname, "../src/reader/scanx_reader.wasm"),
+        resolve(import.meta.dirname, "../src/reader", READER_WASM),
       )
     ).buffer as ArrayBuffer,
   },
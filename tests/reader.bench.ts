@@ -0,0 +1,54 @@
+import { readdir, readFile } from "node:fs/promises";
+import { extname, resolve } from "node:path";
+import { createCanvas, loadImage } from "@napi-rs/canvas";
+import { beforeAll, bench, describe } from "vitest";
+import { prepareScanXModule, readBarcodes } from "../src/reader/index.js";
+import { READER_WASM } from "./utils.js";
+
+const samplesDirectory = resolve(import.meta.dirname, "samples");
+
+// Every sample image as RGBA pixels, so the pixmap path (RGBA -> luma) is measured as well
+const imageDataList = await Promise.all(
+  (await readdir(samplesDirectory, { recursive: true }))
+    .filter((path) => [".png", ".jpg", ".jpeg"].includes(extname(path)))
+    .map(async (path) => {
+      const image = await loadImage(
+        await readFile(resolve(samplesDirectory, path)),
+      );
+      const canvas = createCanvas(image.width, image.height);
+      const context = canvas.getContext("2d");
+      context.drawImage(image, 0, 0, image.width, image.height);
+      return context.getImageData(
+        0,
+        0,
+        image.width,
+        image.height,
+      ) as ImageData;
+    }),
+);
+
+for (const wasmFile of [
+  READER_WASM,
+  READER_WASM.replace(".wasm", "_simd.wasm"),
+]) {
+  describe(`${wasmFile}, ${imageDataList.length} samples`, () => {
+    beforeAll(async () => {
+      await prepareScanXModule({
+        overrides: {
+          wasmBinary: (
+            await readFile(
+              resolve(import.meta.dirname, "../src/reader", wasmFile),
+            )
+          ).buffer as ArrayBuffer,
+        },
+        fireImmediately: true,
+      });
+    });
+
+    bench("readBarcodes(ImageData)", async () => {
+      for (const imageData of imageDataList) {
+        await readBarcodes(imageData);
+      }
+    });
+  });
+}
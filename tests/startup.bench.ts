@@ -0,0 +1,37 @@
+import { readFile } from "node:fs/promises";
+import { resolve } from "node:path";
+import { gzipSync } from "node:zlib";
+import { bench, describe } from "vitest";
+import * as reader from "../src/reader/index.js";
+import * as readerLinear from "../src/reader-linear/index.js";
+import * as readerMatrix from "../src/reader-matrix/index.js";
+import * as readerQR from "../src/reader-qr/index.js";
+import { READER_WASM } from "./utils.js";
+
+const kB = (bytes: number) => Math.round(bytes / 1024);
+
+// Startup of every reader build: compiling and instantiating its module from
+// memory. The download is left out, it scales with the gzipped size in the
+// group name.
+for (const [entry, wasmFile] of [
+  [reader, READER_WASM],
+  [readerQR, "scanx_reader_qr.wasm"],
+  [readerLinear, "scanx_reader_linear.wasm"],
+  [readerMatrix, "scanx_reader_matrix.wasm"],
+] as const) {
+  const wasmBinary = await readFile(
+    resolve(import.meta.dirname, "../src/reader", wasmFile),
+  );
+  const size = kB(wasmBinary.byteLength);
+  const gzipped = kB(gzipSync(wasmBinary).byteLength);
+
+  describe(`${wasmFile}, ${size} kB, ${gzipped} kB gzipped`, () => {
+    bench("compile and instantiate", async () => {
+      entry.purgeScanXModule();
+      await entry.prepareScanXModule({
+        overrides: { wasmBinary: wasmBinary.buffer as ArrayBuffer },
+        fireImmediately: true,
+      });
+    });
+  });
+}
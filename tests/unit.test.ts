@@ -8,9 +8,30 @@ import {
   purgeScanXModule as purgeScanXFullModule,
 } from "../src/full/index.js";
 import {
+  createScannerSession,
+  getReaderStats,
   prepareScanXModule as prepareScanXReaderModule,
   readBarcodes,
+  readBarcodesFromFrames,
+  readBarcodesFromImages,
+  readBarcodesPacked,
+  resetReaderStats,
 } from "../src/reader/index.js";
+import * as readerLinear from "../src/reader-linear/index.js";
+import * as readerMatrix from "../src/reader-matrix/index.js";
+import * as readerQR from "../src/reader-qr/index.js";
+import { createScanXPool, type ScanXPoolOptions } from "../src/pool/index.js";
+import {
+  getWriteCacheStats,
+  prepareScanXModule as prepareScanXWriterModule,
+  prewarmScanXModule as prewarmScanXWriterModule,
+  purgeScanXModule as purgeScanXWriterModule,
+  purgeWriteCache,
+  setWriteCacheCapacity,
+  writeBarcode,
+  writeBarcodes,
+} from "../src/writer/index.js";
+import { READER_WASM } from "./utils.js";
 
 describe("prepare zxing module", () => {
   const consoleMock = vi.spyOn(console, "error").mockImplementation(() => {});
@@ -184,6 +205,30 @@ describe("prepare zxing module", () => {
 
     expect(modulePromise2).toBe(modulePromise3);
   });
+
+  test("wasmCache compiles the module once across instantiations", async () => {
+    const compile = vi.spyOn(WebAssembly, "compile");
+    const overrides = {
+      locateFile: (path: string) =>
+        resolve(import.meta.dirname, "../src/writer", path),
+    };
+
+    await prewarmScanXWriterModule({ overrides, wasmCache: true });
+    expect(compile).toHaveBeenCalledTimes(1);
+    for (let i = 0; i < 2; ++i) {
+      purgeScanXWriterModule();
+      const ScanXModule = await prepareScanXWriterModule({
+        overrides,
+        fireImmediately: true,
+      });
+      expect(ScanXModule.writeBarcodeFromText).toBeTypeOf("function");
+    }
+    expect(compile).toHaveBeenCalledTimes(1);
+
+    compile.mockRestore();
+    purgeScanXWriterModule();
+    prepareScanXWriterModule({ wasmCache: false });
+  });
 });
 
 describe("readBarcodes input", async () => {
@@ -196,7 +241,7 @@ describe("readBarcodes input", async () => {
       overrides: {
         wasmBinary: (
           await readFile(
-            resolve(import.meta.dirname, "../src/reader/scanx_reader.wasm"),
+            resolve(import.meta.dirname, "../src/reader", READER_WASM),
           )
         ).buffer as ArrayBuffer,
       },
@@ -249,4 +294,664 @@ describe("readBarcodes input", async () => {
     expect(readResult).length(1);
     expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
   });
+
+  test("readBarcodes accepts luma planes and NV12 / I420 frames as input", async () => {
+    const image = await loadImage(arrayBuffer);
+    const canvas = createCanvas(image.width, image.height);
+    const context = canvas.getContext("2d");
+    context.drawImage(image, 0, 0, image.width, image.height);
+    const { data, width, height } = context.getImageData(
+      0,
+      0,
+      image.width,
+      image.height,
+    );
+
+    // Pad every row to exercise the row stride.
+    const rowStride = width + 16;
+    const chromaSize = 2 * Math.ceil(width / 2) * Math.ceil(height / 2);
+    const yuv = new Uint8Array(rowStride * height + chromaSize).fill(128);
+    for (let y = 0; y < height; ++y) {
+      for (let x = 0; x < width; ++x) {
+        const i = (y * width + x) * 4;
+        yuv[y * rowStride + x] =
+          (306 * data[i] + 601 * data[i + 1] + 117 * data[i + 2] + 0x200) >>
+          10;
+      }
+    }
+
+    for (const format of ["Lum", "NV12", "I420"] as const) {
+      const readResult = await readBarcodes({
+        data: yuv,
+        width,
+        height,
+        rowStride,
+        format,
+      });
+      expect(readResult).length(1);
+      expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+    }
+  });
+
+  test("readBarcodes reads regions of interest in full-frame coordinates", async () => {
+    const [full] = await readBarcodes(arrayBuffer);
+    const { topLeft, bottomRight } = full.position;
+    const margin = 20;
+    const region = {
+      x: topLeft.x - margin,
+      y: topLeft.y - margin,
+      width: bottomRight.x - topLeft.x + 2 * margin,
+      height: bottomRight.y - topLeft.y + 2 * margin,
+    };
+
+    const readResult = await readBarcodes(arrayBuffer, {
+      regions: [region, { ...region, x: region.x + 1, y: region.y + 1 }],
+    });
+    expect(readResult).length(1);
+    expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+    // The binarizer blocks shift with the crop, so allow a pixel of jitter.
+    for (const corner of [
+      "topLeft",
+      "topRight",
+      "bottomLeft",
+      "bottomRight",
+    ] as const) {
+      const { x, y } = readResult[0].position[corner];
+      expect(Math.abs(x - full.position[corner].x)).toBeLessThanOrEqual(1);
+      expect(Math.abs(y - full.position[corner].y)).toBeLessThanOrEqual(1);
+    }
+
+    const outside = await readBarcodes(arrayBuffer, {
+      regions: { x: 0, y: 0, width: 1, height: 1 },
+    });
+    expect(outside).length(0);
+  });
+
+  test("readBarcodes reads large images in tiles with tileMemoryLimit", async () => {
+    const image = await loadImage(arrayBuffer);
+    const canvas = createCanvas(2400, 2400);
+    const context = canvas.getContext("2d");
+    context.fillStyle = "white";
+    context.fillRect(0, 0, canvas.width, canvas.height);
+    context.drawImage(image, 1500, 1700);
+    const png = await canvas.encode("png");
+
+    const [full] = await readBarcodes(png);
+    // Small enough to split the image into a grid of tiles, several of which hold the whole symbol.
+    const readResult = await readBarcodes(png, {
+      tileMemoryLimit: 4 << 20,
+      tileOverlap: 512,
+    });
+    expect(readResult).length(1);
+    expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+    for (const corner of [
+      "topLeft",
+      "topRight",
+      "bottomLeft",
+      "bottomRight",
+    ] as const) {
+      const { x, y } = readResult[0].position[corner];
+      expect(Math.abs(x - full.position[corner].x)).toBeLessThanOrEqual(2);
+      expect(Math.abs(y - full.position[corner].y)).toBeLessThanOrEqual(2);
+    }
+  });
+
+  test("readBarcodes reduces large encoded images with downscaleOnDecode", async () => {
+    const image = await loadImage(arrayBuffer);
+    const canvas = createCanvas(image.width * 4, image.height * 4);
+    const context = canvas.getContext("2d");
+    context.imageSmoothingEnabled = false;
+    context.drawImage(image, 0, 0, canvas.width, canvas.height);
+    const png = await canvas.encode("png");
+
+    const readerOptions = {
+      downscaleThreshold: 100,
+      downscaleFactor: 2,
+    };
+    const [full] = await readBarcodes(png, readerOptions);
+    const readResult = await readBarcodes(png, {
+      ...readerOptions,
+      downscaleOnDecode: true,
+    });
+    expect(readResult).length(1);
+    expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+    // Positions are mapped back to the full image, up to the reduction scale.
+    const scale = Math.floor(canvas.width / 200);
+    for (const corner of [
+      "topLeft",
+      "topRight",
+      "bottomLeft",
+      "bottomRight",
+    ] as const) {
+      const { x, y } = readResult[0].position[corner];
+      expect(Math.abs(x - full.position[corner].x)).toBeLessThanOrEqual(
+        2 * scale,
+      );
+      expect(Math.abs(y - full.position[corner].y)).toBeLessThanOrEqual(
+        2 * scale,
+      );
+    }
+  });
+
+  test("readBarcodes returns a read profile with profile", async () => {
+    expect(await readBarcodes(arrayBuffer)).not.toHaveProperty("profile");
+
+    const readResult = await readBarcodes(arrayBuffer, { profile: true });
+    expect(readResult).length(1);
+    const { profile } = readResult;
+    expect(profile).toBeDefined();
+    for (const stage of [
+      "decodeMs",
+      "authMs",
+      "readMs",
+      "marshalMs",
+    ] as const) {
+      expect(profile![stage]).toBeGreaterThanOrEqual(0);
+    }
+    expect(profile!.totalMs).toBeGreaterThanOrEqual(
+      profile!.decodeMs + profile!.readMs,
+    );
+
+    const packed = await readBarcodesPacked(arrayBuffer, { profile: true });
+    expect(packed.profile?.readMs).toBeGreaterThanOrEqual(0);
+  });
+
+  test("readBarcodes reports the cascade tier that read the image", async () => {
+    expect(await readBarcodes(arrayBuffer)).not.toHaveProperty("cascadeTier");
+
+    const cascade = [
+      { tryHarder: false, tryRotate: false, tryInvert: false },
+      { tryHarder: true, tryRotate: true, tryInvert: true },
+    ];
+    const readResult = await readBarcodes(arrayBuffer, { cascade });
+    expect(readResult).length(1);
+    expect(readResult.cascadeTier).toBe(0);
+
+    const missed = await readBarcodes(arrayBuffer, {
+      formats: ["EAN-13"],
+      cascade,
+    });
+    expect(missed).length(0);
+    expect(missed.cascadeTier).toBe(-1);
+
+    const [batchReadResults] = await readBarcodesFromImages([arrayBuffer], {
+      cascade,
+    });
+    expect(batchReadResults.cascadeTier).toBe(0);
+  });
+
+  test("readBarcodes skips the passes past timeBudgetMs", async () => {
+    expect(await readBarcodes(arrayBuffer)).not.toHaveProperty(
+      "budgetExceeded",
+    );
+
+    const cascade = [
+      { tryHarder: false, tryRotate: false, tryInvert: false },
+      { tryHarder: true, tryRotate: true, tryInvert: true },
+    ];
+    const readResult = await readBarcodes(arrayBuffer, {
+      cascade,
+      timeBudgetMs: 10_000,
+    });
+    expect(readResult).length(1);
+    expect(readResult.budgetExceeded).toBe(false);
+
+    // The first tier always runs and misses, the budget is gone before the second one
+    const truncated = await readBarcodes(arrayBuffer, {
+      formats: ["EAN-13"],
+      cascade,
+      timeBudgetMs: 0.001,
+    });
+    expect(truncated).length(0);
+    expect(truncated.budgetExceeded).toBe(true);
+    expect(truncated.cascadeTier).toBe(-1);
+
+    const [batchReadResults] = await readBarcodesFromImages([arrayBuffer], {
+      formats: ["EAN-13"],
+      cascade,
+      timeBudgetMs: 0.001,
+    });
+    expect(batchReadResults.budgetExceeded).toBe(true);
+  });
+
+  test("getReaderStats counts reads until resetReaderStats", async () => {
+    await resetReaderStats();
+    await readBarcodes(arrayBuffer);
+    await readBarcodesPacked(arrayBuffer);
+
+    const stats = await getReaderStats();
+    expect(stats.calls).toBe(2);
+    expect(stats.formats.QRCode?.count).toBe(2);
+    expect(stats.formats.QRCode?.readMs).toBeGreaterThanOrEqual(0);
+    expect(stats.heapHighWater).toBeGreaterThan(0);
+    expect(stats.allocations).toBeGreaterThan(0);
+
+    await resetReaderStats();
+    const reset = await getReaderStats();
+    expect(reset.calls).toBe(0);
+    expect(reset.formats).toEqual({});
+    expect(reset.allocations).toBeLessThan(stats.allocations);
+  });
+
+  test("readBarcodesPacked matches readBarcodes", async () => {
+    const [expected] = await readBarcodes(arrayBuffer);
+    const readResult = await readBarcodesPacked(arrayBuffer);
+    expect(readResult).length(1);
+    const [packed] = readResult;
+    expect(packed.text).toBe(expected.text);
+    expect(packed.format).toBe(expected.format);
+    expect(packed.contentType).toBe(expected.contentType);
+    expect(packed.ecLevel).toBe(expected.ecLevel);
+    expect(packed.position).toEqual(expected.position);
+    expect(packed.bytes).toEqual(expected.bytes);
+    expect(packed.bytesECI).toEqual(expected.bytesECI);
+    expect(packed.symbol.width).toBe(expected.symbol.width);
+    expect(packed.symbol.data).toEqual(expected.symbol.data);
+    expect(packed.isValid).toBe(expected.isValid);
+    expect(packed.status).toBe(expected.status);
+
+    const [omitted] = await readBarcodesPacked(arrayBuffer, undefined, [
+      "symbol",
+      "bytesECI",
+    ]);
+    expect(omitted.text).toBe(expected.text);
+    expect(omitted.bytesECI).length(0);
+    expect(omitted.symbol.width).toBe(0);
+    expect(omitted.symbol.data).length(0);
+  });
+
+  test("readBarcodesFromImages reads every image of a batch", async () => {
+    const [expected] = await readBarcodes(arrayBuffer);
+    const batchReadResults = await readBarcodesFromImages([
+      arrayBuffer,
+      new Uint8Array([1, 2, 3, 4]),
+      new Blob([arrayBuffer]),
+    ]);
+    expect(batchReadResults).length(3);
+    for (const index of [0, 2]) {
+      expect(batchReadResults[index]).length(1);
+      expect(batchReadResults[index][0].text).toBe(expected.text);
+      expect(batchReadResults[index][0].position).toEqual(expected.position);
+    }
+    expect(batchReadResults[1]).length(1);
+    expect(batchReadResults[1][0].error).not.toBe("");
+    expect(batchReadResults[1][0].status).toBe(0);
+  });
+
+  test("readBarcodesFromFrames reads every frame of an animated GIF", async () => {
+    // A blank frame followed by two frames of the QR code
+    const gif = await readFile(
+      fileURLToPath(
+        new URL("./samples/qrcode/wikipedia-frames.gif", import.meta.url),
+      ),
+    );
+    const [expected] = await readBarcodes(arrayBuffer);
+    const frameReadResults = await readBarcodesFromFrames(gif);
+    expect(frameReadResults).length(3);
+    expect(frameReadResults[0]).length(0);
+    for (const index of [1, 2]) {
+      expect(frameReadResults[index]).length(1);
+      expect(frameReadResults[index][0].text).toBe(expected.text);
+    }
+
+    const untilFirstCode = await readBarcodesFromFrames(gif, undefined, {
+      stopAtFirstCode: true,
+    });
+    expect(untilFirstCode).length(2);
+    expect(untilFirstCode[1][0].text).toBe(expected.text);
+
+    // Any other image is a single frame
+    const [single] = await readBarcodesFromFrames(arrayBuffer);
+    expect(single[0].position).toEqual(expected.position);
+  });
+});
+
+describe("slim reader builds", async () => {
+  const arrayBuffer = await readFile(
+    fileURLToPath(new URL("./samples/qrcode/wikipedia.png", import.meta.url)),
+  );
+
+  test("a slim build only reads the formats compiled into it", async () => {
+    for (const [reader, wasmFile, count] of [
+      [readerQR, "scanx_reader_qr.wasm", 1],
+      [readerMatrix, "scanx_reader_matrix.wasm", 1],
+      [readerLinear, "scanx_reader_linear.wasm", 0],
+    ] as const) {
+      await reader.prepareScanXModule({
+        overrides: {
+          wasmBinary: (
+            await readFile(
+              resolve(import.meta.dirname, "../src/reader", wasmFile),
+            )
+          ).buffer as ArrayBuffer,
+        },
+        fireImmediately: true,
+      });
+      const readResults = await reader.readBarcodes(arrayBuffer);
+      expect(readResults).length(count);
+      if (count) expect(readResults[0].format).toBe("QRCode");
+    }
+  });
+});
+
+describe("ScannerSession", async () => {
+  const arrayBuffer = await readFile(
+    fileURLToPath(new URL("./samples/qrcode/wikipedia.png", import.meta.url)),
+  );
+
+  beforeAll(async () => {
+    await prepareScanXReaderModule({
+      overrides: {
+        wasmBinary: (
+          await readFile(
+            resolve(import.meta.dirname, "../src/reader", READER_WASM),
+          )
+        ).buffer as ArrayBuffer,
+      },
+      fireImmediately: true,
+    });
+  });
+
+  test("session reads consecutive inputs", async () => {
+    const session = await createScannerSession();
+    for (let i = 0; i < 3; ++i) {
+      const readResult = await session.readBarcodes(arrayBuffer);
+      expect(readResult).length(1);
+      expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+    }
+    session.dispose();
+  });
+
+  test("session reads ImageData frames", async () => {
+    const image = await loadImage(arrayBuffer);
+    const canvas = createCanvas(image.width, image.height);
+    const context = canvas.getContext("2d");
+    context.drawImage(image, 0, 0, image.width, image.height);
+    const imageData = context.getImageData(0, 0, image.width, image.height);
+
+    const session = await createScannerSession({ formats: ["QRCode"] });
+    for (let i = 0; i < 3; ++i) {
+      const readResult = await session.readBarcodes(imageData as ImageData);
+      expect(readResult).length(1);
+      expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+    }
+    session.dispose();
+  });
+
+  test("session reads packed results", async () => {
+    const session = await createScannerSession();
+    for (let i = 0; i < 3; ++i) {
+      const readResult = await session.readBarcodesPacked(arrayBuffer, [
+        "symbol",
+      ]);
+      expect(readResult).length(1);
+      expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+    }
+    session.dispose();
+  });
+
+  test("tracking keeps the track ID of a barcode across frames", async () => {
+    const session = await createScannerSession();
+    const [untracked] = await session.readBarcodes(arrayBuffer);
+    expect(untracked.trackId).toBeUndefined();
+
+    session.setTracking(5);
+    const trackIds = new Set<number | undefined>();
+    for (let i = 0; i < 12; ++i) {
+      const readResult = await session.readBarcodes(arrayBuffer);
+      expect(readResult).length(1);
+      expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+      trackIds.add(readResult[0].trackId);
+    }
+    expect([...trackIds]).toEqual([0]);
+
+    session.setTracking(0);
+    const [afterTracking] = await session.readBarcodesPacked(arrayBuffer);
+    expect(afterTracking.trackId).toBeUndefined();
+    session.dispose();
+  });
+
+  test("change detection reuses the results of unchanged frames", async () => {
+    const session = await createScannerSession();
+    const undetected = await session.readBarcodes(arrayBuffer);
+    expect(undetected.unchanged).toBeUndefined();
+
+    session.setChangeDetection(2);
+    await resetReaderStats();
+    for (let i = 0; i < 4; ++i) {
+      const readResult = await session.readBarcodes(arrayBuffer);
+      expect(readResult).length(1);
+      expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+      expect(readResult.unchanged).toBe(i > 0);
+    }
+    expect(session.getChangeDetectionStats()).toEqual({
+      frames: 4,
+      skipped: 3,
+    });
+    // Skipped frames were never read
+    expect((await getReaderStats()).calls).toBe(1);
+
+    session.setChangeDetection(0);
+    const afterDetection = await session.readBarcodesPacked(arrayBuffer);
+    expect(afterDetection.unchanged).toBeUndefined();
+    session.dispose();
+  });
+
+  test("disposed session rejects reads", async () => {
+    const session = await createScannerSession();
+    session.dispose();
+    await expect(session.readBarcodes(arrayBuffer)).rejects.toThrowError();
+  });
+});
+
+describe("writeBarcode outputs", async () => {
+  beforeAll(async () => {
+    await prepareScanXWriterModule({
+      overrides: {
+        wasmBinary: (
+          await readFile(
+            resolve(import.meta.dirname, "../src/writer/scanx_writer.wasm"),
+          )
+        ).buffer as ArrayBuffer,
+      },
+      fireImmediately: true,
+    });
+    await prepareScanXReaderModule({
+      overrides: {
+        wasmBinary: (
+          await readFile(
+            resolve(import.meta.dirname, "../src/reader", READER_WASM),
+          )
+        ).buffer as ArrayBuffer,
+      },
+      fireImmediately: true,
+    });
+  });
+
+  test("default outputs are png, svg, utf8 and symbol", async () => {
+    const writeResult = await writeBarcode("Hello world!");
+    expect(writeResult.error).toBe("");
+    expect(writeResult.image).toBeInstanceOf(Blob);
+    expect(writeResult.svg).not.toBe("");
+    expect(writeResult.utf8).not.toBe("");
+    expect(writeResult.symbol.width).toBeGreaterThan(0);
+    expect(writeResult.pixmap).toBeNull();
+  });
+
+  test("only the requested outputs are produced", async () => {
+    const writeResult = await writeBarcode("Hello world!", {
+      outputs: ["pixmap"],
+      scale: 4,
+    });
+    expect(writeResult.error).toBe("");
+    expect(writeResult.image).toBeNull();
+    expect(writeResult.svg).toBe("");
+    expect(writeResult.utf8).toBe("");
+    expect(writeResult.symbol.width).toBe(0);
+
+    const pixmap = writeResult.pixmap!;
+    expect(pixmap.data).length(pixmap.width * pixmap.height * 4);
+    const readResult = await readBarcodes(pixmap as ImageData);
+    expect(readResult).length(1);
+    expect(readResult[0].text).toBe("Hello world!");
+
+    const { pixmap: lumPixmap } = await writeBarcode("Hello world!", {
+      outputs: ["pixmap"],
+      pixmapFormat: "Lum",
+      scale: 4,
+    });
+    expect(lumPixmap!.data).length(pixmap.width * pixmap.height);
+  });
+
+  test("batch results match per-call results", async () => {
+    const inputs = ["Hello", "world!", "0123456789"];
+    const writeResults = await writeBarcodes(inputs);
+    expect(writeResults).length(inputs.length);
+    for (const [i, input] of inputs.entries()) {
+      const writeResult = await writeBarcode(input);
+      expect(writeResults[i].error).toBe("");
+      expect(writeResults[i].svg).toBe(writeResult.svg);
+      expect(writeResults[i].utf8).toBe(writeResult.utf8);
+      expect(writeResults[i].symbol).toEqual(writeResult.symbol);
+    }
+  });
+
+  test("a batch may mix text and binary payloads", async () => {
+    const bytes = new TextEncoder().encode("world!");
+    const writeResults = await writeBarcodes(["Hello", bytes]);
+    expect(writeResults).length(2);
+    expect(writeResults[0].svg).toBe((await writeBarcode("Hello")).svg);
+    expect(writeResults[1].svg).toBe((await writeBarcode(bytes)).svg);
+  });
+
+  test("a failing batch entry does not abort the others", async () => {
+    const writeResults = await writeBarcodes(
+      ["4006381333931", "not a number"],
+      { format: "EAN13" },
+    );
+    expect(writeResults[0].error).toBe("");
+    expect(writeResults[0].image).toBeInstanceOf(Blob);
+    expect(writeResults[1].error).not.toBe("");
+    expect(writeResults[1].image).toBeNull();
+  });
+
+  test("repeated payloads are served from the write cache", async () => {
+    await purgeWriteCache();
+    const first = await writeBarcode("SKU-0001", { outputs: ["svg"] });
+    const second = await writeBarcode("SKU-0001", { outputs: ["svg"] });
+    expect(second.svg).toBe(first.svg);
+    // Different options are a different entry
+    await writeBarcode("SKU-0001", { outputs: ["svg"], scale: 2 });
+    expect(await getWriteCacheStats()).toMatchObject({
+      hits: 1,
+      misses: 2,
+      entries: 2,
+    });
+    // Batch writes bypass the cache
+    const [batched] = await writeBarcodes(["SKU-0001", "SKU-0002"], {
+      outputs: ["svg"],
+    });
+    expect(batched.svg).toBe(first.svg);
+    expect(await getWriteCacheStats()).toMatchObject({
+      hits: 1,
+      misses: 2,
+      entries: 2,
+    });
+
+    await setWriteCacheCapacity(0);
+    expect(await getWriteCacheStats()).toMatchObject({
+      entries: 0,
+      bytes: 0,
+      capacity: 0,
+    });
+    const uncached = await writeBarcode("SKU-0001", { outputs: ["svg"] });
+    expect(uncached.svg).toBe(first.svg);
+    await setWriteCacheCapacity(4 << 20);
+    await purgeWriteCache();
+    expect(await getWriteCacheStats()).toMatchObject({ hits: 0, misses: 0 });
+  });
+});
+
+describe("ScanXPool", async () => {
+  const arrayBuffer = await readFile(
+    fileURLToPath(new URL("./samples/qrcode/wikipedia.png", import.meta.url)),
+  );
+  const poolOptions: ScanXPoolOptions = {
+    overrides: {
+      wasmBinary: (
+        await readFile(
+          resolve(import.meta.dirname, "../src/full/scanx_full.wasm"),
+        )
+      ).buffer as ArrayBuffer,
+    },
+    // The workers run the TypeScript source of the worker script through tsx.
+    workerUrl: new URL("../src/pool/worker.ts", import.meta.url),
+    workerOptions: { execArgv: ["--import", "tsx"] },
+  };
+
+  test("pool reads and writes on several workers", async () => {
+    const pool = createScanXPool({ ...poolOptions, size: 2 });
+    try {
+      const readResults = await Promise.all(
+        Array.from({ length: 4 }, () => pool.readBarcodes(arrayBuffer)),
+      );
+      for (const readResult of readResults) {
+        expect(readResult).length(1);
+        expect(readResult[0].text).toBe("http://en.m.wikipedia.org");
+      }
+
+      const writeResult = await pool.writeBarcode("Hello world!");
+      expect(writeResult.error).toBe("");
+      expect(writeResult.image).toBeInstanceOf(Blob);
+    } finally {
+      await pool.terminate();
+    }
+  });
+
+  test("a full queue rejects new tasks", async () => {
+    const pool = createScanXPool({ ...poolOptions, size: 1, maxQueueSize: 1 });
+    try {
+      const running = pool.readBarcodes(arrayBuffer);
+      const queued = pool.readBarcodes(arrayBuffer);
+      expect(pool.queueSize).toBe(1);
+      await expect(pool.readBarcodes(arrayBuffer)).rejects.toThrow(
+        "queue is full",
+      );
+      expect(await running).length(1);
+      expect(await queued).length(1);
+    } finally {
+      await pool.terminate();
+    }
+  });
+
+  test("transferred inputs are detached", async () => {
+    const pool = createScanXPool({ ...poolOptions, transferInputs: true });
+    try {
+      const input = new Uint8Array(arrayBuffer);
+      const readResult = pool.readBarcodes(input);
+      expect(input.byteLength).toBe(0);
+      expect(await readResult).length(1);
+    } finally {
+      await pool.terminate();
+    }
+  });
+
+  test("a task that cannot be posted only fails itself", async () => {
+    const pool = createScanXPool({
+      ...poolOptions,
+      size: 1,
+      transferInputs: true,
+    });
+    try {
+      const input = new Uint8Array(arrayBuffer);
+      const running = pool.readBarcodes(input);
+      // Queued behind the first task, its input is detached by then
+      const detached = pool.readBarcodes(input);
+      expect(await running).length(1);
+      await expect(detached).rejects.toThrowError();
+      expect(await pool.readBarcodes(arrayBuffer)).length(1);
+    } finally {
+      await pool.terminate();
+    }
+  });
 });
@@ -10,6 +10,15 @@ import {
   type ReadOutputBarcodeFormat,
   type ReadResult,
 } from "../src/reader/index.js";
+import { supportsThreads } from "../src/share.js";
+
+/**
+ * The `.wasm` file of the reader entry, which loads the multithreaded build wherever it can,
+ * Node.js included.
+ */
+export const READER_WASM = supportsThreads()
+  ? "scanx_reader_mt.wasm"
+  : "scanx_reader.wasm";
 
 export const DEFAULT_READER_OPTIONS_FOR_TESTS: ReaderOptions = {
   ...defaultReaderOptions,
@@ -0,0 +1,44 @@
+import { readFile } from "node:fs/promises";
+import { resolve } from "node:path";
+import { beforeAll, bench, describe } from "vitest";
+import {
+  prepareScanXModule,
+  type WriterOptions,
+  writeBarcode,
+  writeBarcodes,
+} from "../src/writer/index.js";
+
+const labels = Array.from(
+  { length: 200 },
+  (_, i) => `LABEL-${i.toString().padStart(6, "0")}`,
+);
+
+beforeAll(async () => {
+  await prepareScanXModule({
+    overrides: {
+      wasmBinary: (
+        await readFile(
+          resolve(import.meta.dirname, "../src/writer/scanx_writer.wasm"),
+        )
+      ).buffer as ArrayBuffer,
+    },
+    fireImmediately: true,
+  });
+});
+
+for (const writerOptions of [
+  { outputs: ["png"] },
+  { outputs: ["svg"] },
+] satisfies WriterOptions[]) {
+  describe(`${labels.length} labels, ${writerOptions.outputs}`, () => {
+    bench("writeBarcode per label", async () => {
+      for (const label of labels) {
+        await writeBarcode(label, writerOptions);
+      }
+    });
+
+    bench("writeBarcodes batch", async () => {
+      await writeBarcodes(labels, writerOptions);
+    });
+  });
+}
@@ -7,25 +7,40 @@ import { defineConfig } from "vitest/config";
 import { version } from "./package.json";
 import { emscriptenPatch } from "./scripts/babel-plugin-emscripten-patch.js";
 
+async function wasmHash(path: string) {
+  return createHash("sha256")
+    .update(
+      await readFile(fileURLToPath(new URL(`./src/${path}`, import.meta.url))),
+    )
+    .digest("hex");
+}
+
 export default defineConfig({
   build: {
     target: ["es2020", "edge88", "firefox68", "chrome75", "safari13"],
     lib: {
       entry: {
         "reader/index": "src/reader/index.ts",
+        "reader-qr/index": "src/reader-qr/index.ts",
+        "reader-linear/index": "src/reader-linear/index.ts",
+        "reader-matrix/index": "src/reader-matrix/index.ts",
         "writer/index": "src/writer/index.ts",
         "full/index": "src/full/index.ts",
+        "pool/index": "src/pool/index.ts",
+        "pool/worker": "src/pool/worker.ts",
       },
       formats: ["es"],
       fileName: (_, entryName) => `${entryName}.js`,
     },
     outDir: "dist/es",
     rollupOptions: {
+      // Node.js builtins, only imported by the worker pool
+      external: [/^node:/],
       output: {
         chunkFileNames: "[name].js",
         manualChunks: (id) => {
           if (
-            /share\.ts|exposedReaderBindings\.ts|exposedWriterBindings\.ts/.test(
+            /share\.ts|wasmCache\.ts|exposedReaderBindings\.ts|exposedWriterBindings\.ts/.test(
               id,
             )
           ) {
@@ -40,46 +55,47 @@ export default defineConfig({
       babelConfig: {
         plugins: [emscriptenPatch()],
       },
-      filter: /scanx_(reader|writer|full)\.js$/,
-      include: /scanx_(reader|writer|full)\.js$/,
+      filter: /scanx_(reader|writer|full)(_mt|_qr|_linear|_matrix)?\.js$/,
+      include: /scanx_(reader|writer|full)(_mt|_qr|_linear|_matrix)?\.js$/,
     }),
   ],
   define: {
     NPM_PACKAGE_VERSION: JSON.stringify(version),
     "import.meta.vitest": "undefined",
-    READER_HASH: JSON.stringify(
-      createHash("sha256")
-        .update(
-          await readFile(
-            fileURLToPath(
-              new URL("./src/reader/scanx_reader.wasm", import.meta.url),
-            ),
-          ),
-        )
-        .digest("hex"),
+    READER_HASH: JSON.stringify(await wasmHash("reader/scanx_reader.wasm")),
+    READER_SIMD_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_simd.wasm"),
+    ),
+    READER_MT_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_mt.wasm"),
+    ),
+    READER_MT_SIMD_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_mt_simd.wasm"),
+    ),
+    READER_QR_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_qr.wasm"),
+    ),
+    READER_QR_SIMD_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_qr_simd.wasm"),
+    ),
+    READER_LINEAR_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_linear.wasm"),
+    ),
+    READER_LINEAR_SIMD_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_linear_simd.wasm"),
+    ),
+    READER_MATRIX_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_matrix.wasm"),
     ),
-    WRITER_HASH: JSON.stringify(
-      createHash("sha256")
-        .update(
-          await readFile(
-            fileURLToPath(
-              new URL("./src/writer/scanx_writer.wasm", import.meta.url),
-            ),
-          ),
-        )
-        .digest("hex"),
+    READER_MATRIX_SIMD_HASH: JSON.stringify(
+      await wasmHash("reader/scanx_reader_matrix_simd.wasm"),
     ),
-    FULL_HASH: JSON.stringify(
-      createHash("sha256")
-        .update(
-          await readFile(
-            fileURLToPath(
-              new URL("./src/full/scanx_full.wasm", import.meta.url),
-            ),
-          ),
-        )
-        .digest("hex"),
+    WRITER_HASH: JSON.stringify(await wasmHash("writer/scanx_writer.wasm")),
+    WRITER_SIMD_HASH: JSON.stringify(
+      await wasmHash("writer/scanx_writer_simd.wasm"),
     ),
+    FULL_HASH: JSON.stringify(await wasmHash("full/scanx_full.wasm")),
+    FULL_SIMD_HASH: JSON.stringify(await wasmHash("full/scanx_full_simd.wasm")),
     SUBMODULE_COMMIT: JSON.stringify(
       execSync("git submodule status | cut -c-41", {
         encoding: "utf-8",